@@ -9,7 +9,7 @@
 // Engine includes.
 #include "dragonfly/DisplayManager.h"
 #include "dragonfly/WorldManager.h"
-#include "dragonfly/EventCollision.h"
+#include "dragonfly/EventTrigger.h"
 
 // Game includes.
 #include "FloorManager.h"
@@ -17,14 +17,12 @@
 
 Checkpoint::Checkpoint(df::Vector pos, int width, int height, bool finalCheckpoint) {
 	setType("Checkpoint");
-	setSolidness(df::Solidness::SOFT); // Only overlaps objects
+	setFilterType("Player"); // Only the player sets it off
 	setPosition(pos);
 	setBox(df::Box(df::Vector(-1.0 * width / 2.0, -1.0 * height / 2.0), width, height));
 	fired = false;
 	isFinal = finalCheckpoint;
 	WM.insertObject(this);
-
-	registerInterest(df::COLLISION_EVENT);
 }
 
 bool Checkpoint::hasFired() const {
@@ -32,18 +30,17 @@ bool Checkpoint::hasFired() const {
 }
 
 int Checkpoint::eventHandler(const df::Event* p_e) {
-	if (!fired && p_e->getType() == df::COLLISION_EVENT) {
-		if (((df::EventCollision*)p_e)->getObject1()->getType() == "Player") {
-			fired = true;
-			if (isFinal) {
-				((Player*)((df::EventCollision*)p_e)->getObject1())->endAnim();
-				new GameOver;
-			}
-			else {
-				FM.nextFloor();
-			}
-			return 1;
+	// Checkpoints are one-shot: walking back onto one does not fire it again.
+	if (!fired && p_e->getType() == df::TRIGGER_EVENT && ((df::EventTrigger*)p_e)->isEnter()) {
+		fired = true;
+		if (isFinal) {
+			((Player*)((df::EventTrigger*)p_e)->getObject())->endAnim();
+			new GameOver;
+		}
+		else {
+			FM.nextFloor();
 		}
+		return 1;
 	}
 	return 0;
 }
@@ -8,9 +8,9 @@
 #define __CHECKPOINT_H__
 
 // Engine includes
-#include "dragonfly/Object.h"
+#include "dragonfly/Trigger.h"
 
-class Checkpoint : public df::Object {
+class Checkpoint : public df::Trigger {
 private:
 	bool fired;
 	bool isFinal;
@@ -7,24 +7,54 @@
 #include "EnemyBat.h"
 
 // Engine includes.
+#include "dragonfly/GameManager.h"
 #include "dragonfly/WorldManager.h"
 #include "dragonfly/ResourceManager.h"
 #include "dragonfly/EventStep.h"
 #include "dragonfly/utility.h"
 
+// Game includes.
+#include "Player.h"
+
 EnemyBat::EnemyBat() {
-    setType("Bat");
+    setParallelStep(); // Player scan runs in the parallel step phase.
 	randomOffset = rand() % 1000; // not important enough to use a good rng so just use rand
-    setSprite("bat");
+    dieSound = RM.getSoundHandle("bat_die");
 
-    // make the hitbox smaller so it can't hit the player from as far away
-    auto b = getBox();
-    b = df::Box(df::Vector(b.getCorner().getX() + 0.5f, b.getCorner().getY() + 0.25f), b.getHorizontal() - 1.0f, b.getVertical() - 0.5f);
-    setBox(b);
+    // type, sprite and the smaller hitbox come from prefabs/prefabs.txt
+    applyPrefab(RM.getPrefab("bat"));
 }
 
 EnemyBat::~EnemyBat() {
-    RM.getSound("bat_die")->play();
+    if (RM.getSound(dieSound)) RM.getSound(dieSound)->play();
+}
+
+void EnemyBat::stepParallel(int /*step_count*/) {
+    // only scan for the player once in a while (helps with performance)
+    scanCooldown--;
+    if(scanCooldown <= 0) {
+        pxd = 0.0f;
+        pyd = 0.0f;
+        nearPlayer = false;
+        scanCooldown = 15;
+
+        // player in range?
+        df::Object* player = WM.nearest(getPosition(), df::QueryFilter(PLAYER_TYPE), 32);
+        if(player) {
+            // calculate direction to player
+            float pdx = getPosition().getX() - player->getPosition().getX();
+            float pdy = getPosition().getY() - player->getPosition().getY();
+
+            df::Vector mov(pdx, pdy);
+            mov.normalize();
+
+            // move towards player (faster horizontally than vertically)
+            pxd = -mov.getX() / 2.0f;
+            pyd = -mov.getY() / 4.0f;
+
+            nearPlayer = true;
+        }
+    }
 }
 
 int EnemyBat::eventHandler(const df::Event* ev) {
@@ -32,45 +62,10 @@ int EnemyBat::eventHandler(const df::Event* ev) {
     if(ev->getType() == df::STEP_EVENT) {
         // layer a bunch of sines with arbitrary multipliers for easy "random" movement
         // randomOffset shifts the sines around a bit so that different bats have different movement
-        long time = df::getTime();
+        long time = GM.getStepCount() * df::FRAME_TIME_DEFAULT; // Step based so replays match.
         float dx = sin((time + randomOffset * 1.0) / 310.1) / 10.0f + sin((time + randomOffset * 2.0) / 500.1) / 10.0f + sin((time + randomOffset * 7.0) / 221.6) / 20.0f + sin((time + randomOffset * 4.0) / 104.2) / 20.0f;
         float dy = sin((time + randomOffset * 1.1) / 580.1) / 12.0f + sin((time + randomOffset * 5.0) / 377.3) / 12.0f + sin((time + randomOffset * 2.0) / 202.7) / 20.0f + sin((time + randomOffset * 3.0) / 82.4) / 10.0f;
 
-        // only scan for the player once in a while (helps with performance)
-        scanCooldown--;
-        if(scanCooldown <= 0) {
-            pxd = 0.0f;
-            pyd = 0.0f;
-            nearPlayer = false;
-            scanCooldown = 15;
-
-            df::ObjectList ol = WM.getSceneGraph().activeObjects();
-            df::ObjectListIterator toUpdate(&ol);
-            toUpdate.first();
-            std::string x = "";
-            while(!toUpdate.isDone() && toUpdate.currentObject()) {
-                if(toUpdate.currentObject()->getType() == "Player") {
-                    float dist = (getPosition() - toUpdate.currentObject()->getPosition()).getMagnitude();
-                    // if in range
-                    if(dist < 32) {
-                        // calculate direction to player
-                        float pdx = getPosition().getX() - toUpdate.currentObject()->getPosition().getX();
-                        float pdy = getPosition().getY() - toUpdate.currentObject()->getPosition().getY();
-
-                        df::Vector mov(pdx, pdy);
-                        mov.normalize();
-
-                        // move towards player (faster horizontally than vertically)
-                        pxd = -mov.getX() / 2.0f;
-                        pyd = -mov.getY() / 4.0f;
-
-                        nearPlayer = true;
-                    }
-                }
-                toUpdate.next();
-            }
-        }
-
         if(nearPlayer) {
             dx += pxd;
             dy += pyd;
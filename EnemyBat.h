@@ -16,10 +16,14 @@ private:
 	float pxd = 0.0f;
 	float pyd = 0.0f;
 	int scanCooldown = 15;
+	df::SoundHandle dieSound;
 public:
 	EnemyBat();
 	~EnemyBat();
 
 	virtual int eventHandler(const df::Event* ev);
+
+	// Look for the player (reads the world, writes only own fields).
+	virtual void stepParallel(int step_count);
 };
 #endif // __ENEMY_BAT_H__
\ No newline at end of file
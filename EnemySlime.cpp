@@ -11,20 +11,44 @@
 #include "dragonfly/ResourceManager.h"
 #include "dragonfly/EventStep.h"
 
+// Game includes.
+#include "Player.h"
+
 EnemySlime::EnemySlime() {
-    setType("Slime");
-	hasGravity(true);
-    setSprite("slime");
-
-    // make the hitbox smaller so it can't hit the player from as far away
-    auto b = getBox();
-    b = df::Box(df::Vector(b.getCorner().getX() + 0.5f, b.getCorner().getY() + 1.25f), b.getHorizontal() - 1.0f, b.getVertical() - 1.25f);
-    setBox(b);
+    setParallelStep(); // Player scan runs in the parallel step phase.
+    jumpSound = RM.getSoundHandle("slime_jump");
+    dieSound = RM.getSoundHandle("slime_die");
+
+    // type, sprite, gravity and the smaller hitbox come from prefabs/prefabs.txt
+    applyPrefab(RM.getPrefab("slime"));
 }
 
 EnemySlime::~EnemySlime() {
-    RM.getSound("slime_die")->getSound()->setVolume(50);
-    RM.getSound("slime_die")->play();
+    df::Sound* sound = RM.getSound(dieSound);
+    if (sound) {
+        sound->getSound()->setVolume(50);
+        sound->play();
+    }
+}
+
+void EnemySlime::stepParallel(int /*step_count*/) {
+    // only scan for the player once in a while (helps with performance)
+    scanCooldown--;
+    if(scanCooldown <= 0) {
+        nearPlayer = false;
+        hDir = 0.0f;
+        scanCooldown = 15;
+
+        // player in range?
+        df::Object* player = WM.nearest(getPosition(), df::QueryFilter(PLAYER_TYPE), 20);
+        if(player) {
+            nearPlayer = true;
+
+            // determine if player is to the left or right
+            float dx = getPosition().getX() - player->getPosition().getX();
+            hDir = dx > 0 ? -0.5f : 0.5f;
+        }
+    }
 }
 
 int EnemySlime::eventHandler(const df::Event* ev) {
@@ -32,33 +56,6 @@ int EnemySlime::eventHandler(const df::Event* ev) {
     if(ev->getType() == df::STEP_EVENT) {
         bool ground = isGrounded();
 
-        // only scan for the player once in a while (helps with performance)
-        scanCooldown--;
-        if(scanCooldown <= 0) {
-            nearPlayer = false;
-            hDir = 0.0f;
-            scanCooldown = 15;
-
-            df::ObjectList ol = WM.getSceneGraph().activeObjects();
-            df::ObjectListIterator toUpdate(&ol);
-            toUpdate.first();
-            std::string x = "";
-            while(!toUpdate.isDone() && toUpdate.currentObject()) {
-                if(toUpdate.currentObject()->getType() == "Player") {
-                    float dist = (getPosition() - toUpdate.currentObject()->getPosition()).getMagnitude();
-                    // if in range
-                    if(dist < 20) {
-                        nearPlayer = true;
-                    }
-
-                    // determine if player is to the left or right
-                    float dx = getPosition().getX() - toUpdate.currentObject()->getPosition().getX();
-                    hDir = dx > 0 ? -0.5f : 0.5f;
-                }
-                toUpdate.next();
-            }
-        }
-
         // if doesnt see the player
         if(!nearPlayer) {
             resetJumpCooldown();
@@ -82,8 +79,11 @@ int EnemySlime::eventHandler(const df::Event* ev) {
 
         if(jumpCooldown <= 0) {
             // jump towards player
-            RM.getSound("slime_jump")->getSound()->setVolume(50);
-            RM.getSound("slime_jump")->play();
+            df::Sound* sound = RM.getSound(jumpSound);
+            if (sound) {
+                sound->getSound()->setVolume(50);
+                sound->play();
+            }
 
             float jumpStrength = 0.5f;
             jumpStrength += (rand() % 100) / 100.0f * 0.15f;
@@ -15,12 +15,17 @@ private:
 	bool nearPlayer = false;
 	float hDir = 0.0f;
 	int scanCooldown = 15;
+	df::SoundHandle jumpSound;
+	df::SoundHandle dieSound;
 public:
 	EnemySlime();
 	~EnemySlime();
 
 	virtual int eventHandler(const df::Event* ev);
 
+	// Look for the player (reads the world, writes only own fields).
+	virtual void stepParallel(int step_count);
+
 	void resetJumpCooldown();
 };
 #endif // __ENEMY_SLIME_H__
\ No newline at end of file
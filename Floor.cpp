@@ -8,12 +8,11 @@
 
 // Engine includes.
 #include "dragonfly/DisplayManager.h"
-#include "dragonfly/WorldManager.h"
+#include "dragonfly/ResourceManager.h"
 
 Floor::Floor(df::Vector pos) {
-	setType("Floor");
 	setPosition(pos);
-	WM.insertObject(this);
+	applyPrefab(RM.getPrefab("floor"));
 }
 
 int Floor::draw() {
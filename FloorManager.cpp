@@ -10,6 +10,7 @@
 #include "dragonfly/DisplayManager.h"
 #include "dragonfly/GameManager.h"
 #include "dragonfly/LogManager.h"
+#include "dragonfly/Trigger.h"
 #include "dragonfly/WorldManager.h"
 #include "dragonfly/utility.h"
 
@@ -19,10 +20,16 @@
 #include "Player.h"
 #include "GameOver.h"
 #include "StartMenu.h"
+#include "Terrain.h"
 
 #include "EnemySlime.h"
 #include "EnemyBat.h"
 
+// System includes.
+#include <vector>
+
+const df::StringId KILL_PLANE_TYPE = df::intern("KillPlane");
+
 FloorManager::FloorManager() {
 	setType("FloorManager");
 	// TODO: set this based on save file read.
@@ -30,9 +37,10 @@ FloorManager::FloorManager() {
 	floorSize = 5;
 	noise = 80;
 	previousEndHeight = 0;
-	player = NULL;
-	nextCheckpoint = NULL;
-	currentCheckpoint = NULL;
+	player = df::Handle();
+	nextCheckpoint = df::Handle();
+	currentCheckpoint = df::Handle();
+	killPlane = df::Handle();
 	worldHeight = 1000;
 	maxLevel = 5;
 	seed = df::getTime();
@@ -45,9 +53,10 @@ FloorManager::FloorManager(FloorManager const&) {
 	floorSize = 5;
 	noise = 10;
 	previousEndHeight = 0;
-	player = NULL;
-	nextCheckpoint = NULL;
-	currentCheckpoint = NULL;
+	player = df::Handle();
+	nextCheckpoint = df::Handle();
+	currentCheckpoint = df::Handle();
+	killPlane = df::Handle();
 	worldHeight = 1000;
 	maxLevel = 100;
 	seed = df::getTime();
@@ -80,6 +89,10 @@ int FloorManager::getFloor() const {
 	return currentFloor;
 }
 
+void FloorManager::setSeed(long new_seed) {
+	seed = new_seed;
+}
+
 void FloorManager::setFloor(int new_floor) {
 	currentFloor = new_floor;
 }
@@ -112,26 +125,34 @@ int FloorManager::nextFloor() {
 
 	df::Box view = WM.getView(), boundary = WM.getBoundary();
 
+	// Generate the height of every column of the floor in one batch.
+	// Noise is sampled in world columns so floors line up with each other.
+	const int firstColumn = -4;
+	std::vector<int> heights(levelWidth - firstColumn);
+	Terrain terrain(seed, floorSize, noise);
+	terrain.heightmap((currentFloor * levelWidth) + 10 + firstColumn, (int)heights.size(), previousEndHeight, -(worldHeight - 20), 0, heights.data());
+
+	// Starting area, built on the first floor: a ledge startWidth wide, startDepth above the world floor,
+	// with walls at leftWall and rightWall. The left wall runs down into the world floor.
+	const int startWidth = 100, startDepth = 250, leftWall = 5, rightWall = 25, leftWallBelow = 20;
+
+	// Spawn the whole floor as one batch, so the world indexes it in one pass.
+	int expected = (int)heights.size() + totalEnemies + 1;
+	if (!player.isValid()) {
+		const int walls = (startDepth - 1 + leftWallBelow) + (startDepth - 1);
+		const int ledge = startWidth - (rightWall - leftWall + 1);
+		expected += walls + ledge + 2; // Plus the player and the start menu.
+	}
+	WM.beginSpawnBatch(expected);
+
 	int chHeight = 0;
-	for (int x = -4; x < levelWidth; x++) {
+	for (int x = firstColumn; x < levelWidth; x++) {
 		if (currentFloor == maxLevel) {
 			new Floor(df::Vector((currentFloor * levelWidth) + 10.0f + x, worldHeight + 20.0f + floorHeight));
 			if(x == levelWidth / 2) chHeight = floorHeight;
 		}
 		else {
-			srand((currentFloor + 1 + seed) * (x + 2) * (rand() % 50));
-			if (x % floorSize == 0) {
-				int height = rand() % 200 - 100;
-				if (abs(height) >= 100 - noise) {
-					if (height >= 0 && floorHeight < 0 && worldHeight > abs(floorHeight) + 20) {
-						floorHeight++;
-					}
-					else if (height < 0) {
-						floorHeight--;
-					}
-				}
-			}
-			// simple sin wave for testing. height = (int)(sin(x / 10.0f) * 2.0f + sin(x / 3.14f) * 2.0f);
+			floorHeight = heights[x - firstColumn];
 			new Floor(df::Vector((currentFloor * levelWidth) + 10.0f + x, worldHeight + 20.0f + floorHeight));
 			if(x == levelWidth / 2) chHeight = floorHeight;
 
@@ -149,29 +170,30 @@ int FloorManager::nextFloor() {
 				}
 				enemies++;
 			}
-			else if (!player && x == 0) {
+			else if (!player.isValid() && x == 0) {
 				// Make world really tall
 				WM.setBoundary(df::Box(df::Vector(), 10 + levelWidth, worldHeight + view.getVertical()));
 				boundary = WM.getBoundary();
 
 				// Create floor for player
-				for (int i = 0; i < 100; i++) {
-					if (i == 5 || i == 25) {
-						for (int j = worldHeight - 249; j < worldHeight + (i == 5 ? 20 : 0); j++) {
+				for (int i = 0; i < startWidth; i++) {
+					if (i == leftWall || i == rightWall) {
+						for (int j = worldHeight - (startDepth - 1); j < worldHeight + (i == leftWall ? leftWallBelow : 0); j++) {
 							new Wall(df::Vector(i, j));
 						}
-					} else if (i < 5 || i > 25) {
-						new Floor(df::Vector(i, worldHeight - 250));
+					} else if (i < leftWall || i > rightWall) {
+						new Floor(df::Vector(i, worldHeight - startDepth));
 					}
 				}
 
 				// Create the player
-				player = new Player();
-				player->setPosition(df::Vector(95, worldHeight - 250 - 2));
+				Player* p_player = new Player();
+				p_player->setPosition(df::Vector(95, worldHeight - startDepth - 2));
+				player = p_player->getHandle();
 
-				WM.setViewPosition(df::Vector(0, player->getPosition().getY() - 4.5));
+				WM.setViewPosition(df::Vector(0, p_player->getPosition().getY() - 4.5));
 
-				StartMenu* st = new StartMenu(player);
+				StartMenu* st = new StartMenu(p_player);
 			}
 		}
 	}
@@ -180,7 +202,9 @@ int FloorManager::nextFloor() {
 
 	// Create checkpoint the end of the level
 	currentCheckpoint = nextCheckpoint;
-	nextCheckpoint = new Checkpoint(df::Vector((currentFloor * levelWidth) + (levelWidth / 2), worldHeight + 20 + chHeight - 2), 1, DM.getVertical(), currentFloor == maxLevel);
+	nextCheckpoint = (new Checkpoint(df::Vector((currentFloor * levelWidth) + (levelWidth / 2), worldHeight + 20 + chHeight - 2), 1, DM.getVertical(), currentFloor == maxLevel))->getHandle();
+
+	WM.endSpawnBatch();
 	
 	currentFloor++;
 
@@ -198,19 +222,39 @@ int FloorManager::nextFloor() {
 	}
 	WM.setBoundary(boundary);
 
+	// Falling below the floors costs the player health (see Player). Widen the kill plane with the world.
+	df::Object* p_kill_plane = WM.getObject(killPlane);
+	if (!p_kill_plane) {
+		df::Trigger* p_trigger = new df::Trigger();
+		p_trigger->setType("KillPlane");
+		p_trigger->setFilterType("Player");
+		p_trigger->setPosition(df::Vector(boundary.getCorner().getX(), worldHeight + 40.0f));
+		WM.insertObject(p_trigger);
+		killPlane = p_trigger->getHandle();
+		p_kill_plane = p_trigger;
+	}
+	p_kill_plane->setBox(df::Box(df::Vector(), boundary.getHorizontal(), 60));
+
 	// TODO: load custom settings for next floor if implemented
 
 	return 0;
 }
 
 int FloorManager::respawn() {
+	df::Object* p_checkpoint = WM.getObject(currentCheckpoint);
+	if (!p_checkpoint) {
+		LM.writeLog("ERROR", "FloorManager", "No checkpoint to respawn at.");
+		return -1;
+	}
+
 	// Create the player
-	player = new Player();
-	player->setPosition(currentCheckpoint->getPosition() - df::Vector(0, 3));
-	player->setVelocity(df::Vector(0.5, 0));
+	Player* p_player = new Player();
+	p_player->setPosition(p_checkpoint->getPosition() - df::Vector(0, 3));
+	p_player->setVelocity(df::Vector(0.5, 0));
+	player = p_player->getHandle();
 
 	// Make camera follow player
-	WM.setViewFollowing(player);
+	WM.setViewFollowing(p_player);
 	WM.setViewSlack(df::Vector(0.25, 0.25));
 	return 1;
 }
\ No newline at end of file
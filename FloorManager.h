@@ -8,6 +8,7 @@
 #define __FLOOR_MANAGER_H__
 
 // Engine includes.
+#include "dragonfly/Handle.h"
 #include "dragonfly/Manager.h"
 
 // Game includes.
@@ -16,6 +17,9 @@
 
 #define FM FloorManager::getInstance()
 
+// Interned "KillPlane" type, of the trigger below the floors.
+extern const df::StringId KILL_PLANE_TYPE;
+
 class FloorManager : public df::Manager {
 private:
 	FloorManager();                 // Private since a singleton.
@@ -25,11 +29,12 @@ private:
 	int floorSize; // The width of the floor in characters.
 	int noise; // A higher number causes more topographical terrain. 0<=noise<=100
 	int previousEndHeight; // The previous ending height.
-	Player* player; // The player pointer.
+	df::Handle player; // The player (stale once the player dies).
 	int worldHeight;
 	int maxLevel;
-	Checkpoint* nextCheckpoint;
-	Checkpoint* currentCheckpoint;
+	df::Handle nextCheckpoint;
+	df::Handle currentCheckpoint;
+	df::Handle killPlane; // Trigger below the floors, widened with the world.
 	long seed;
 public:
 	// Get the one and only instance of the FloorManager.
@@ -54,6 +59,9 @@ public:
 	// Set noise.
 	void setNoise(int new_noise);
 
+	// Set seed for terrain and enemy placement.
+	void setSeed(long new_seed);
+
 	// Clear this floor and load the next floor.
 	// Return 0 on success, -1 otherwise
 	int nextFloor();
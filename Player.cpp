@@ -15,6 +15,7 @@
 
 #include "dragonfly/EventStep.h"
 #include "dragonfly/EventCollision.h"
+#include "dragonfly/EventTrigger.h"
 #include "dragonfly/EventKeyboard.h"
 #include "dragonfly/EventMouse.h"
 
@@ -27,6 +28,8 @@
 
 static int lives = 1;
 
+const df::StringId PLAYER_TYPE = df::intern("Player");
+
 Player::Player() {
 	setType("Player");
 
@@ -46,7 +49,11 @@ Player::Player() {
 	registerInterest(df::KEYBOARD_EVENT);
 	registerInterest(df::MSE_EVENT);
 
-	
+	bodySprite = RM.getSpriteHandle("player-idle-body");
+	walkSprite = RM.getSpriteHandle("player-walk");
+	jumpSound = RM.getSoundHandle("jump");
+	hitSound = RM.getSoundHandle("hit");
+	hurtSound = RM.getSoundHandle("hurt");
 
 	setSprite("player-bounds");
 }
@@ -74,7 +81,7 @@ int Player::eventHandler(const df::Event* p_e) {
 				}
 				else {
 					setVelocity({ getVelocity().getX(), -0.6f });
-					RM.getSound("jump")->play();
+					if (RM.getSound(jumpSound)) RM.getSound(jumpSound)->play();
 					startAnimFire = true;
 				}
 			} else if (startTickCounter < 30 * 14) {
@@ -88,13 +95,6 @@ int Player::eventHandler(const df::Event* p_e) {
 			}
 		}
 
-		if(getPosition().getY() > 1040) {
-			damage(1.0f, getPosition());
-			invulnerability = 60;
-			setPosition({getPosition().getX(), 1010});
-			setVelocity({0.1, -0.25});
-		}
-
 		// update movement
 		tickMovement();
 		return 1;
@@ -108,6 +108,16 @@ int Player::eventHandler(const df::Event* p_e) {
 		else if (dynamic_cast<EnemyMaster*>(ce->getObject2())) {
 			damage(1.0f, ce->getObject2()->getPosition());
 		}
+	} else if (p_e->getType() == df::TRIGGER_EVENT) {
+		df::EventTrigger* te = (df::EventTrigger*)p_e;
+
+		// fell off the floors, take damage and drop back in from above the kill plane
+		if (te->isEnter() && te->getTrigger()->getTypeId() == KILL_PLANE_TYPE) {
+			damage(1.0f, getPosition());
+			invulnerability = 60;
+			setPosition({getPosition().getX(), te->getTrigger()->getWorldAabb().min_y - 30});
+			setVelocity({0.1, -0.25});
+		}
 	} else if (!(playStartAnim || playEndAnim) && animStartFlag) {
 		if(p_e->getType() == df::KEYBOARD_EVENT) {
 			df::EventKeyboard* ke = (df::EventKeyboard*)p_e;
@@ -153,8 +163,11 @@ int Player::eventHandler(const df::Event* p_e) {
 				PlayerAttack* atk = new PlayerAttack(this, left, ofsY);
 				atk->setPosition(this->getPosition() + df::Vector(0, -0.5f + ofsY));
 
-				RM.getSound("hit")->getSound()->setVolume(50);
-				RM.getSound("hit")->play();
+				df::Sound* sound = RM.getSound(hitSound); // May still be loading.
+				if (sound) {
+					sound->getSound()->setVolume(50);
+					sound->play();
+				}
 			}
 		}
 	}
@@ -180,7 +193,7 @@ int Player::draw() {
 	// flash during invulnerability
 	bool flash = invulnerability % 6 >= 5;
 
-	if(!flash) RM.getSprite("player-idle-body")->draw(0, this->getPosition() + df::Vector(-1, -1));
+	if(!flash) RM.getSprite(bodySprite)->draw(0, this->getPosition() + df::Vector(-1, -1));
 
 	// decide which frame for the legs
 	// 0 = "/ \"
@@ -202,7 +215,7 @@ int Player::draw() {
 		}
 	}
 
-	if(!flash) RM.getSprite("player-walk")->draw(legFrame, this->getPosition() + df::Vector(-1, 0.2f + 1));
+	if(!flash) RM.getSprite(walkSprite)->draw(legFrame, this->getPosition() + df::Vector(-1, 0.2f + 1));
 
 	return Object::draw();
 }
@@ -283,8 +296,11 @@ void Player::jump() {
 	// start jump
 	if (isGrounded() && !playStartAnim && !playEndAnim) {
 		setVelocity({ getVelocity().getX(), -0.6f });
-		RM.getSound("jump")->getSound()->setVolume(50);
-		RM.getSound("jump")->play();
+		df::Sound* sound = RM.getSound(jumpSound); // May still be loading.
+		if (sound) {
+			sound->getSound()->setVolume(50);
+			sound->play();
+		}
 	}
 }
 
@@ -298,7 +314,7 @@ void Player::endJump() {
 void Player::damage(float damage, df::Vector source) {
 	// no damage if invulnerable
 	if(invulnerability > 0) return;
-	RM.getSound("hurt")->play();
+	if (RM.getSound(hurtSound)) RM.getSound(hurtSound)->play();
 
 	health -= damage;
 	if(health <= 0) {
@@ -324,10 +340,16 @@ void Player::die() {
         FM.respawn();
     }
     else {
-		RM.getSound("gameover")->getSound()->setVolume(50);
-		RM.getSound("gameover")->play();
-		RM.getMusic("bgMusic")->getMusic()->setVolume(30);
-		RM.getMusic("bgMusic")->getMusic()->setPitch(0.2);
+		df::Sound* sound = RM.getSound("gameover");
+		if (sound) {
+			sound->getSound()->setVolume(50);
+			sound->play();
+		}
+		df::Music* music = RM.getMusic("bgMusic");
+		if (music) {
+			music->getMusic()->setVolume(30);
+			music->getMusic()->setPitch(0.2);
+		}
         new GameOver;
     }
 }
@@ -345,7 +367,7 @@ PlayerAttack::PlayerAttack(Player* pl, bool left, float yOffset) {
 	setSolidness(df::Solidness::SOFT);
 	setSprite(left ? "player-attack-l" : "player-attack-r");
 
-	this->player = pl;
+	this->player = pl->getHandle();
 	this->left = left;
 	this->yOffset = yOffset;
 	this->lifetime = 20;
@@ -359,6 +381,9 @@ PlayerAttack::PlayerAttack(Player* pl, bool left, float yOffset) {
 	}
 	setBox(b);
 	
+	registerInterest(df::STEP_EVENT);
+	// An enemy only needs deleting once.
+	setCollisionPhases(false, false);
 	registerInterest(df::COLLISION_EVENT);
 
 }
@@ -367,7 +392,13 @@ int PlayerAttack::eventHandler(const df::Event* p_e) {
 
 	if(p_e->getType() == df::STEP_EVENT) {
 
-		setPosition(player->getPosition() + df::Vector(left ? -0.5f : 0.5f, -0.5f + yOffset));
+		df::Object* p_player = WM.getObject(player);
+		if(!p_player) {
+			// Player died mid-swing.
+			WM.markForDelete(this);
+			return 1;
+		}
+		setPosition(p_player->getPosition() + df::Vector(left ? -0.5f : 0.5f, -0.5f + yOffset));
 
 		this->lifetime--;
 		if(lifetime == 12) {
@@ -11,9 +11,12 @@
 
 class Player;
 
+// Interned "Player" type, for WM.firstOfType() and type checks.
+extern const df::StringId PLAYER_TYPE;
+
 class PlayerAttack : public df::Object {
 	int lifetime;
-	Player* player;
+	df::Handle player;
 	bool left;
 	float yOffset = 0;
 
@@ -44,6 +47,13 @@ class Player : public df::Object {
 
 	bool animStartFlag = false;
 
+	// Resources used every frame or on every action, resolved once in the constructor.
+	df::SpriteHandle bodySprite;
+	df::SpriteHandle walkSprite;
+	df::SoundHandle jumpSound;
+	df::SoundHandle hitSound;
+	df::SoundHandle hurtSound;
+
 public:
 
 	Player();
@@ -19,7 +19,7 @@ StartMenu::StartMenu(Player* pl) {
 	df::Box v = WM.getView();
 	setPosition(df::viewToWorld(df::Vector(v.getHorizontal() / 2, v.getVertical()/2))); // Set location to center
 	setSprite("startmenu");
-	this->player = pl;
+	this->player = pl->getHandle();
 
 	registerInterest(df::KEYBOARD_EVENT);
 }
@@ -33,7 +33,10 @@ int StartMenu::eventHandler(const df::Event* p_e) {
 
 		if(ke->getKey() == df::Keyboard::Key::SPACE) {
 
-			player->startFlag();
+			Player* p_player = (Player*)WM.getObject(player);
+			if(p_player) {
+				p_player->startFlag();
+			}
 
 			return 1;
 		}
@@ -10,7 +10,7 @@
 
 class StartMenu : public df::ViewObject {
 private:
-	Player* player;
+	df::Handle player;
 
 	void step(void);
 public:
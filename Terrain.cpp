@@ -0,0 +1,193 @@
+/**
+	Noise based terrain generation.
+	@file Terrain.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "Terrain.h"
+
+// System includes.
+#include <cmath>
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TERRAIN_SSE2
+#include <emmintrin.h>
+#endif
+
+// Floor division (rounds towards negative infinity).
+static long floorDiv(long a, long b) {
+	long q = a / b;
+	if ((a % b != 0) && ((a < 0) != (b < 0))) {
+		q--;
+	}
+	return q;
+}
+
+Terrain::Terrain(unsigned long seed, int floorSize, int noise) {
+	this->seed = seed;
+	this->floorSize = floorSize > 0 ? floorSize : 1;
+	if (noise > 100) {
+		noise = 100;
+	}
+	else if (noise < 0) {
+		noise = 0;
+	}
+	this->noise = noise;
+}
+
+int Terrain::getSpacing() const {
+	return floorSize * 6;
+}
+
+float Terrain::latticeValue(long ix, long iy) const {
+	unsigned int h = (unsigned int)seed * 0x9E3779B1u;
+	h ^= (unsigned int)ix * 0x85EBCA77u;
+	h ^= (unsigned int)iy * 0xC2B2AE3Du;
+	h ^= h >> 15;
+	h *= 0x2C1B3C6Du;
+	h ^= h >> 12;
+	h *= 0x297A2D39u;
+	h ^= h >> 15;
+	return (float)(h & 0xFFFFFF) / (float)0x7FFFFF - 1.0f;
+}
+
+void Terrain::addRow(const float* lattice, long c0, int spacing, int start_x, int count, float amplitude, float* out) const {
+	const float inv = 1.0f / spacing;
+	int i = 0;
+#ifdef TERRAIN_SSE2
+	// Four columns at a time: split into lattice cell and fraction, smoothstep, then lerp between cell edges.
+	// Cells use the same integer floor division as the scalar tail. x * (1 / spacing) in float can round
+	// an exact multiple of spacing down a cell, which reads before the start of the lattice.
+	const __m128 v_inv = _mm_set1_ps(inv);
+	const __m128 v_two = _mm_set1_ps(2.0f);
+	const __m128 v_three = _mm_set1_ps(3.0f);
+	const __m128 v_amp = _mm_set1_ps(amplitude);
+	int cell[4], offset[4];
+	for (; i + 4 <= count; i += 4) {
+		for (int k = 0; k < 4; k++) {
+			long x = start_x + i + k;
+			cell[k] = (int)floorDiv(x, spacing);
+			offset[k] = (int)(x - (long)cell[k] * spacing);
+		}
+		__m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)offset)), v_inv);
+		__m128 a = _mm_setr_ps(lattice[cell[0] - c0], lattice[cell[1] - c0], lattice[cell[2] - c0], lattice[cell[3] - c0]);
+		__m128 b = _mm_setr_ps(lattice[cell[0] - c0 + 1], lattice[cell[1] - c0 + 1], lattice[cell[2] - c0 + 1], lattice[cell[3] - c0 + 1]);
+		__m128 s = _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(v_three, _mm_mul_ps(v_two, t)));
+		__m128 v = _mm_add_ps(a, _mm_mul_ps(s, _mm_sub_ps(b, a)));
+		_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(v, v_amp)));
+	}
+#endif
+	// Scalar fallback and tail.
+	for (; i < count; i++) {
+		long x = start_x + i;
+		long c = floorDiv(x, spacing);
+		float t = (x - c * spacing) * inv;
+		float s = t * t * (3.0f - 2.0f * t);
+		float a = lattice[c - c0], b = lattice[c - c0 + 1];
+		out[i] += (a + s * (b - a)) * amplitude;
+	}
+}
+
+void Terrain::sample1D(int start_x, int count, float* out) const {
+	if (count <= 0) {
+		return;
+	}
+	for (int i = 0; i < count; i++) {
+		out[i] = 0.0f;
+	}
+	std::vector<float> lattice;
+	int spacing = getSpacing();
+	float amplitude = 1.0f, total = 0.0f;
+	for (int octave = 0; octave < TERRAIN_OCTAVES && spacing > 0; octave++) {
+		long c0 = floorDiv(start_x, spacing), c1 = floorDiv(start_x + count - 1, spacing) + 1;
+		lattice.resize(c1 - c0 + 1);
+		for (long c = c0; c <= c1; c++) {
+			lattice[c - c0] = latticeValue(c, octave);
+		}
+		addRow(lattice.data(), c0, spacing, start_x, count, amplitude, out);
+		total += amplitude;
+		amplitude *= 0.5f;
+		spacing /= 2;
+	}
+	for (int i = 0; i < count; i++) {
+		out[i] /= total;
+	}
+}
+
+void Terrain::sample2D(int start_x, int start_y, int width, int depth, float* out) const {
+	if (width <= 0 || depth <= 0) {
+		return;
+	}
+	for (int i = 0; i < width * depth; i++) {
+		out[i] = 0.0f;
+	}
+	std::vector<float> top, bottom, blend;
+	int spacing = getSpacing();
+	float amplitude = 1.0f, total = 0.0f;
+	for (int octave = 0; octave < TERRAIN_OCTAVES && spacing > 0; octave++) {
+		long c0 = floorDiv(start_x, spacing), c1 = floorDiv(start_x + width - 1, spacing) + 1;
+		top.resize(c1 - c0 + 1);
+		bottom.resize(c1 - c0 + 1);
+		blend.resize(c1 - c0 + 1);
+		long row_cell = floorDiv(start_y, spacing) - 1;
+		for (int y = 0; y < depth; y++) {
+			long cy = floorDiv(start_y + y, spacing);
+			if (cy != row_cell) {
+				// Only rebuild lattice rows when crossing into a new cell row.
+				// Octave is folded into the x hash so octaves don't share lattices.
+				row_cell = cy;
+				for (long c = c0; c <= c1; c++) {
+					top[c - c0] = latticeValue(c + octave * 7919L, cy);
+					bottom[c - c0] = latticeValue(c + octave * 7919L, cy + 1);
+				}
+			}
+			float t = (start_y + y - cy * spacing) / (float)spacing;
+			float s = t * t * (3.0f - 2.0f * t);
+			for (long c = 0; c <= c1 - c0; c++) {
+				blend[c] = top[c] + s * (bottom[c] - top[c]);
+			}
+			addRow(blend.data(), c0, spacing, start_x, width, amplitude, out + y * width);
+		}
+		total += amplitude;
+		amplitude *= 0.5f;
+		spacing /= 2;
+	}
+	for (int i = 0; i < width * depth; i++) {
+		out[i] /= total;
+	}
+}
+
+void Terrain::heightmap(int start_x, int count, int start_height, int min_height, int max_height, int* out) const {
+	if (count <= 0) {
+		return;
+	}
+	std::vector<float> n(count);
+	sample1D(start_x, count, n.data());
+	// Height the noise is pulling towards, relative to where the profile starts.
+	const float amplitude = TERRAIN_MAX_AMPLITUDE * noise / 100.0f;
+	int height = start_height;
+	for (int i = 0; i < count; i++) {
+		if (floorDiv(start_x + i, floorSize) * floorSize == start_x + i) {
+			int target = start_height + (int)floor(amplitude * (n[i] - n[0]) + 0.5f);
+			if (target > height && height < max_height) {
+				height++;
+			}
+			else if (target < height && height > min_height) {
+				height--;
+			}
+		}
+		out[i] = height;
+	}
+}
+
+void Terrain::caveMask(int start_x, int start_y, int width, int depth, float threshold, unsigned char* out) const {
+	if (width <= 0 || depth <= 0) {
+		return;
+	}
+	std::vector<float> n(width * depth);
+	sample2D(start_x, start_y, width, depth, n.data());
+	for (int i = 0; i < width * depth; i++) {
+		out[i] = n[i] > threshold ? 1 : 0;
+	}
+}
@@ -0,0 +1,52 @@
+/**
+	@file Terrain.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __TERRAIN_H__
+#define __TERRAIN_H__
+
+// Maximum height (in characters) the terrain can wander from its starting height at noise 100.
+const float TERRAIN_MAX_AMPLITUDE = 10.0f;
+// Number of noise octaves layered into the height profile.
+const int TERRAIN_OCTAVES = 2;
+
+// Value noise terrain generator.
+// Noise is evaluated in batches over whole rows of columns so a floor is generated in one pass
+// instead of reseeding rand() for every column.
+class Terrain {
+private:
+	unsigned long seed; // Seed for the noise lattice.
+	int floorSize; // Columns between height changes. Also scales the lattice spacing.
+	int noise; // A higher number causes more topographical terrain. 0<=noise<=100
+
+	// Return the lattice spacing (in columns) of the first octave.
+	int getSpacing() const;
+
+	// Return the random lattice value in [-1, 1] for lattice point (ix, iy).
+	float latticeValue(long ix, long iy) const;
+
+	// Interpolate a row of lattice values starting at lattice cell c0 over columns [start_x, start_x + count).
+	// Result is scaled by amplitude and added to out.
+	void addRow(const float* lattice, long c0, int spacing, int start_x, int count, float amplitude, float* out) const;
+public:
+	Terrain(unsigned long seed, int floorSize, int noise);
+
+	// Sample 1-D noise in [-1, 1] for columns [start_x, start_x + count) into out.
+	void sample1D(int start_x, int count, float* out) const;
+
+	// Sample 2-D noise in [-1, 1] for the block of width x depth cells with top-left at (start_x, start_y).
+	// Output is row major (out[y * width + x]).
+	void sample2D(int start_x, int start_y, int width, int depth, float* out) const;
+
+	// Build a height profile for columns [start_x, start_x + count) into out.
+	// The profile starts at start_height, only changes every floorSize columns and by at most 1,
+	// and stays within [min_height, max_height].
+	void heightmap(int start_x, int count, int start_height, int min_height, int max_height, int* out) const;
+
+	// Build a cave mask for the block of width x depth cells with top-left at (start_x, start_y).
+	// A cell is 1 (open) where the 2-D noise is above threshold, else 0 (solid).
+	void caveMask(int start_x, int start_y, int width, int depth, float threshold, unsigned char* out) const;
+};
+#endif // __TERRAIN_H__
@@ -8,12 +8,11 @@
 
 // Engine includes.
 #include "dragonfly/DisplayManager.h"
-#include "dragonfly/WorldManager.h"
+#include "dragonfly/ResourceManager.h"
 
 Wall::Wall(df::Vector pos) : Object() {
-	setType("Wall");
 	setPosition(pos);
-	WM.insertObject(this);
+	applyPrefab(RM.getPrefab("wall"));
 }
 
 int Wall::draw() {
@@ -0,0 +1,35 @@
+/**
+	@file Aabb.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __AABB_H__
+#define __AABB_H__
+
+// Engine includes.
+#include "Box.h"
+
+namespace df {
+
+	// Axis aligned box as its four edges, for tests that run every frame.
+	// Same area as the Box it was made from, without the corner + size arithmetic.
+	struct Aabb {
+		float min_x, min_y; // Upper left corner.
+		float max_x, max_y; // Lower right corner.
+	};
+
+	// Return edges of box.
+	inline Aabb toAabb(const Box& box) {
+		const float x = box.getCorner().getX(), y = box.getCorner().getY();
+		Aabb aabb = { x, y, x + box.getHorizontal(), y + box.getVertical() };
+		return aabb;
+	}
+
+	// Return true if a and b overlap or touch, as with boxIntersectsBox().
+	inline bool aabbIntersectsAabb(const Aabb& a, const Aabb& b) {
+		return a.min_x <= b.max_x && b.min_x <= a.max_x && a.min_y <= b.max_y && b.min_y <= a.max_y;
+	}
+
+} // end of namespace df
+#endif // __AABB_H__
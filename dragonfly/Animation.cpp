@@ -17,27 +17,20 @@ void df::Animation::setSprite(Sprite* p_new_sprite) {
 	m_p_sprite = p_new_sprite;
 	setIndex(0);
 	setSlowdownCount(p_new_sprite->getSlowdown());
-	setName(p_new_sprite->getLabel());
 }
 
 void df::Animation::clearSprite() {
 	m_p_sprite = NULL;
 	setIndex(0);
 	setSlowdownCount(0);
-	setName("");
-
 }
 
 df::Sprite* df::Animation::getSprite() const {
 	return m_p_sprite;
 }
 
-void df::Animation::setName(std::string new_name) {
-	m_name = new_name;
-}
-
 std::string df::Animation::getName() const {
-	return m_name;
+	return m_p_sprite ? m_p_sprite->getLabel() : "";
 }
 
 void df::Animation::setIndex(int new_index) {
@@ -60,14 +53,14 @@ int df::Animation::draw(Vector position) {
 	if (!m_p_sprite) {
 		return 0;
 	}
-	int index = getIndex();
-	int pass = m_p_sprite->draw(index, position);
-	if (pass == -1) {
-		return -1;
-	}
-	if (getSlowdownCount() == -1) {
-		return 0;
+	return m_p_sprite->draw(getIndex(), position) == -1 ? -1 : 0;
+}
+
+void df::Animation::step() {
+	if (!m_p_sprite || getSlowdownCount() == -1) {
+		return;
 	}
+	int index = getIndex();
 	int count = getSlowdownCount() + 1;
 	if (count >= m_p_sprite->getSlowdown()) {
 		count = 0;
@@ -78,7 +71,6 @@ int df::Animation::draw(Vector position) {
 		setIndex(index);
 	}
 	setSlowdownCount(count);
-	return 0;
 }
 
 df::Box df::Animation::getBox() const {
@@ -19,7 +19,6 @@ namespace df {
 		Sprite* m_p_sprite; // Sprite associated with Animation.
 		int m_index; // Current index frame for Sprite.
 		int m_slowdown_count; // Slowdown counter (-1 means stop).
-		std::string m_name; // Sprite name in ResourceManager.
 
 	public:
 		/// Animation constructor
@@ -36,10 +35,7 @@ namespace df {
 		/// Return pointer to associated Sprite.
 		Sprite* getSprite() const;
 
-		/// Set Sprite name (in ResourceManager).
-		void setName(std::string new_name);
-
-		/// Get Sprite name (in ResourceManager).
+		/// Get Sprite name (in ResourceManager), the Sprite's label.
 		std::string getName() const;
 
 		/// Set index of current Sprite frame to be displayed.
@@ -57,10 +53,13 @@ namespace df {
 		/// Get bounding box of associated Sprite.
 		Box getBox() const;
 
-		/// Draw single frame centered at position (x,y).
-		/// Drawing accounts for slowdown, and advances Sprite frame.
+		/// Draw current frame centered at position (x,y).
 		/// Return 0 if ok, else -1.
 		int draw(Vector position);
+
+		/// Advance Sprite frame, accounting for slowdown.
+		/// Called once a frame by the WorldManager for ANIMATED Objects in view.
+		void step();
 	};
 } // end of namespace df
 #endif // __ANIMATION_H__
@@ -0,0 +1,217 @@
+/**
+	Memory mapped asset pack.
+	@file AssetPack.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "AssetPack.h"
+
+// System includes.
+#include <algorithm>
+#include <cstring>
+#include <Windows.h>
+
+namespace {
+
+	// Compare name bytes against an index entry's name.
+	int compareName(const char* p_name, size_t length, const char* p_entry_name, size_t entry_length) {
+		int result = memcmp(p_name, p_entry_name, length < entry_length ? length : entry_length);
+		if (result != 0) {
+			return result;
+		}
+		return length < entry_length ? -1 : (length > entry_length ? 1 : 0);
+	}
+
+	size_t alignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+df::AssetPack::AssetPack() {
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = NULL;
+	p_base = NULL;
+	m_size = 0;
+	p_index = NULL;
+	m_entry_count = 0;
+}
+
+df::AssetPack::~AssetPack() {
+	close();
+}
+
+int df::AssetPack::open(std::string filename, std::string* p_error) {
+	close();
+	m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (m_file == INVALID_HANDLE_VALUE) {
+		*p_error = "cannot open file.";
+		return -1;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size) || size.QuadPart < (LONGLONG)sizeof(df::PackHeader)) {
+		*p_error = "file too small.";
+		close();
+		return -1;
+	}
+	m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!m_mapping) {
+		*p_error = "cannot map file.";
+		close();
+		return -1;
+	}
+	p_base = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!p_base) {
+		*p_error = "cannot map view of file.";
+		close();
+		return -1;
+	}
+	m_size = (size_t)size.QuadPart;
+	if (validate(p_error) == -1) {
+		close();
+		return -1;
+	}
+	return 0;
+}
+
+int df::AssetPack::validate(std::string* p_error) {
+	df::PackHeader header;
+	memcpy(&header, p_base, sizeof(header));
+	if (memcmp(header.magic, df::ASSET_PACK_MAGIC, sizeof(header.magic)) != 0) {
+		*p_error = "not an asset pack.";
+		return -1;
+	}
+	if (header.version != df::ASSET_PACK_VERSION) {
+		*p_error = "unsupported asset pack version " + std::to_string(header.version) + ".";
+		return -1;
+	}
+	const uint64_t index_end = sizeof(df::PackHeader) + (uint64_t)sizeof(df::PackEntry) * header.entry_count;
+	if (index_end > header.names_offset || header.names_offset > m_size) {
+		*p_error = "truncated index.";
+		return -1;
+	}
+	const df::PackEntry* p_entries = (const df::PackEntry*)(p_base + sizeof(df::PackHeader));
+	for (uint32_t i = 0; i < header.entry_count; i++) {
+		const df::PackEntry& entry = p_entries[i];
+		if ((uint64_t)header.names_offset + entry.name_offset + entry.name_length > m_size
+			|| entry.data_offset > m_size || entry.data_size > m_size - entry.data_offset) {
+			*p_error = "entry " + std::to_string(i) + " out of range.";
+			return -1;
+		}
+		if (i > 0) {
+			const df::PackEntry& previous = p_entries[i - 1];
+			const char* p_names = p_base + header.names_offset;
+			if (compareName(p_names + previous.name_offset, previous.name_length, p_names + entry.name_offset, entry.name_length) >= 0) {
+				*p_error = "index not sorted.";
+				return -1;
+			}
+		}
+	}
+	p_index = p_entries;
+	m_entry_count = header.entry_count;
+	return 0;
+}
+
+void df::AssetPack::close() {
+	if (p_base) {
+		UnmapViewOfFile(p_base);
+		p_base = NULL;
+	}
+	if (m_mapping) {
+		CloseHandle(m_mapping);
+		m_mapping = NULL;
+	}
+	if (m_file != INVALID_HANDLE_VALUE) {
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+	m_size = 0;
+	p_index = NULL;
+	m_entry_count = 0;
+}
+
+bool df::AssetPack::isOpen() const {
+	return p_base != NULL;
+}
+
+int df::AssetPack::getCount() const {
+	return (int)m_entry_count;
+}
+
+bool df::AssetPack::find(const std::string& name, const char** p_data, size_t* p_size) const {
+	if (!p_base) {
+		return false;
+	}
+	const std::string key = normalizeName(name);
+	const char* p_names = p_base + ((const df::PackHeader*)p_base)->names_offset;
+	uint32_t low = 0, high = m_entry_count;
+	while (low < high) {
+		uint32_t mid = low + (high - low) / 2;
+		const df::PackEntry& entry = p_index[mid];
+		int result = compareName(key.data(), key.size(), p_names + entry.name_offset, entry.name_length);
+		if (result == 0) {
+			*p_data = p_base + entry.data_offset;
+			*p_size = (size_t)entry.data_size;
+			return true;
+		}
+		if (result < 0) {
+			high = mid;
+		}
+		else {
+			low = mid + 1;
+		}
+	}
+	return false;
+}
+
+std::string df::AssetPack::normalizeName(std::string name) {
+	std::replace(name.begin(), name.end(), '\\', '/');
+	while (name.compare(0, 2, "./") == 0) {
+		name.erase(0, 2);
+	}
+	return name;
+}
+
+int df::AssetPack::write(std::vector<df::PackSource>* p_sources, std::vector<char>* p_out, std::string* p_error) {
+	for (size_t i = 0; i < p_sources->size(); i++) {
+		(*p_sources)[i].name = normalizeName((*p_sources)[i].name);
+	}
+	std::sort(p_sources->begin(), p_sources->end(), [](const df::PackSource& a, const df::PackSource& b) {
+		return compareName(a.name.data(), a.name.size(), b.name.data(), b.name.size()) < 0;
+	});
+	std::string names;
+	std::vector<df::PackEntry> index(p_sources->size());
+	for (size_t i = 0; i < p_sources->size(); i++) {
+		const df::PackSource& source = (*p_sources)[i];
+		if (i > 0 && source.name == (*p_sources)[i - 1].name) {
+			*p_error = "duplicate asset '" + source.name + "'.";
+			return -1;
+		}
+		index[i].name_offset = (uint32_t)names.size();
+		index[i].name_length = (uint32_t)source.name.size();
+		names += source.name;
+	}
+	df::PackHeader header;
+	memcpy(header.magic, df::ASSET_PACK_MAGIC, sizeof(header.magic));
+	header.version = df::ASSET_PACK_VERSION;
+	header.entry_count = (uint32_t)index.size();
+	header.names_offset = (uint32_t)(sizeof(header) + sizeof(df::PackEntry) * index.size());
+	size_t end = header.names_offset + names.size();
+	for (size_t i = 0; i < p_sources->size(); i++) {
+		end = alignUp(end, df::ASSET_PACK_ALIGN);
+		index[i].data_offset = end;
+		index[i].data_size = (*p_sources)[i].data.size();
+		end += (*p_sources)[i].data.size();
+	}
+	p_out->assign(end, 0);
+	memcpy(p_out->data(), &header, sizeof(header));
+	if (!index.empty()) {
+		memcpy(p_out->data() + sizeof(header), index.data(), sizeof(df::PackEntry) * index.size());
+	}
+	memcpy(p_out->data() + header.names_offset, names.data(), names.size());
+	for (size_t i = 0; i < p_sources->size(); i++) {
+		if (!(*p_sources)[i].data.empty()) {
+			memcpy(p_out->data() + index[i].data_offset, (*p_sources)[i].data.data(), (*p_sources)[i].data.size());
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,99 @@
+/**
+	@file AssetPack.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __ASSET_PACK_H__
+#define __ASSET_PACK_H__
+
+// System includes.
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace df {
+
+	// Magic bytes at the start of an asset pack.
+	const char ASSET_PACK_MAGIC[4] = { 'D', 'F', 'P', 'K' };
+
+	// Asset pack version. Bump when the layout changes.
+	const uint32_t ASSET_PACK_VERSION = 1;
+
+	// Alignment of each asset's data in the pack.
+	const uint32_t ASSET_PACK_ALIGN = 16;
+
+	// Header of an asset pack. Stored little endian.
+	// Followed by entry_count PackEntry (sorted by name), the name table and then the asset data.
+	struct PackHeader {
+		char magic[4];        // ASSET_PACK_MAGIC.
+		uint32_t version;     // ASSET_PACK_VERSION.
+		uint32_t entry_count; // Number of assets.
+		uint32_t names_offset; // Start of the name table from the start of the file.
+	};
+
+	// Index entry for one asset.
+	struct PackEntry {
+		uint32_t name_offset; // Start of name in the name table.
+		uint32_t name_length; // Length of name (not null terminated).
+		uint64_t data_offset; // Start of data from the start of the file.
+		uint64_t data_size;   // Size of data in bytes.
+	};
+
+	// Asset to be written into a pack.
+	struct PackSource {
+		std::string name;       // Name to look the asset up by (see AssetPack::normalizeName()).
+		std::vector<char> data; // Asset contents.
+	};
+
+	// Read-only asset pack mapped into memory.
+	// Assets are looked up by name with a binary search over the index and used in place.
+	class AssetPack {
+
+	private:
+		void* m_file;            // OS file handle.
+		void* m_mapping;         // OS file mapping handle.
+		const char* p_base;      // Start of the mapped pack (NULL if not open).
+		size_t m_size;           // Size of the mapped pack.
+		const PackEntry* p_index; // Sorted index inside the mapping.
+		uint32_t m_entry_count;  // Number of entries in index.
+		AssetPack(AssetPack const&);     // Don't allow copy.
+		void operator=(AssetPack const&); // Don't allow assignment.
+
+		// Check header and index of the mapped pack.
+		// Return 0 if ok, else -1 with reason in p_error.
+		int validate(std::string* p_error);
+	public:
+		AssetPack();
+
+		// Unmap pack if open.
+		~AssetPack();
+
+		// Map pack file into memory.
+		// Return 0 if ok, else -1 with reason in p_error.
+		int open(std::string filename, std::string* p_error);
+
+		// Unmap pack. Anything still pointing into the pack is invalid afterwards.
+		void close();
+
+		// Return true if a pack is mapped.
+		bool isOpen() const;
+
+		// Return number of assets in pack.
+		int getCount() const;
+
+		// Find asset with indicated name.
+		// Return true and set pointer to its data and its size if found, else false.
+		bool find(const std::string& name, const char** p_data, size_t* p_size) const;
+
+		// Return name as stored in a pack: forward slashes, no leading "./".
+		static std::string normalizeName(std::string name);
+
+		// Build pack from sources into p_out (replacing contents). Sources are sorted by name.
+		// Return 0 if ok, else -1 with reason in p_error (e.g., duplicate name).
+		static int write(std::vector<PackSource>* p_sources, std::vector<char>* p_out, std::string* p_error);
+	};
+
+} // end of namespace df
+#endif // __ASSET_PACK_H__
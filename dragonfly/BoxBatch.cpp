@@ -0,0 +1,96 @@
+/**
+	Batch box overlap tests.
+	@file BoxBatch.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "BoxBatch.h"
+
+// System includes.
+#if defined(__AVX__)
+#include <immintrin.h>
+#define DF_BOX_BATCH_AVX
+#endif
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DF_BOX_BATCH_SSE
+#endif
+
+void df::BoxBatch::clear() {
+	m_min_x.clear();
+	m_min_y.clear();
+	m_max_x.clear();
+	m_max_y.clear();
+}
+
+void df::BoxBatch::add(const df::Box& box) {
+	add(df::toAabb(box));
+}
+
+void df::BoxBatch::add(const df::Aabb& box) {
+	m_min_x.push_back(box.min_x);
+	m_min_y.push_back(box.min_y);
+	m_max_x.push_back(box.max_x);
+	m_max_y.push_back(box.max_y);
+}
+
+int df::BoxBatch::getCount() const {
+	return (int)m_min_x.size();
+}
+
+int df::BoxBatch::intersect(const df::Box& query, std::vector<int>* p_out) const {
+	return intersect(df::toAabb(query), p_out);
+}
+
+int df::BoxBatch::intersect(const df::Aabb& query, std::vector<int>* p_out) const {
+	p_out->clear();
+	const int count = getCount();
+	const float* p_min_x = m_min_x.data();
+	const float* p_min_y = m_min_y.data();
+	const float* p_max_x = m_max_x.data();
+	const float* p_max_y = m_max_y.data();
+	const float query_min_x = query.min_x, query_min_y = query.min_y;
+	const float query_max_x = query.max_x, query_max_y = query.max_y;
+	int i = 0;
+#ifdef DF_BOX_BATCH_AVX
+	{
+		const __m256 q_min_x = _mm256_set1_ps(query_min_x), q_min_y = _mm256_set1_ps(query_min_y);
+		const __m256 q_max_x = _mm256_set1_ps(query_max_x), q_max_y = _mm256_set1_ps(query_max_y);
+		for (; i + 8 <= count; i += 8) {
+			__m256 hit = _mm256_and_ps(
+				_mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(p_min_x + i), q_max_x, _CMP_LE_OQ), _mm256_cmp_ps(q_min_x, _mm256_loadu_ps(p_max_x + i), _CMP_LE_OQ)),
+				_mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(p_min_y + i), q_max_y, _CMP_LE_OQ), _mm256_cmp_ps(q_min_y, _mm256_loadu_ps(p_max_y + i), _CMP_LE_OQ)));
+			int mask = _mm256_movemask_ps(hit);
+			for (int bit = 0; mask != 0; bit++, mask >>= 1) {
+				if (mask & 1) {
+					p_out->push_back(i + bit);
+				}
+			}
+		}
+	}
+#endif
+#ifdef DF_BOX_BATCH_SSE
+	{
+		const __m128 q_min_x = _mm_set1_ps(query_min_x), q_min_y = _mm_set1_ps(query_min_y);
+		const __m128 q_max_x = _mm_set1_ps(query_max_x), q_max_y = _mm_set1_ps(query_max_y);
+		for (; i + 4 <= count; i += 4) {
+			__m128 hit = _mm_and_ps(
+				_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(p_min_x + i), q_max_x), _mm_cmple_ps(q_min_x, _mm_loadu_ps(p_max_x + i))),
+				_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(p_min_y + i), q_max_y), _mm_cmple_ps(q_min_y, _mm_loadu_ps(p_max_y + i))));
+			int mask = _mm_movemask_ps(hit);
+			for (int bit = 0; mask != 0; bit++, mask >>= 1) {
+				if (mask & 1) {
+					p_out->push_back(i + bit);
+				}
+			}
+		}
+	}
+#endif
+	// Scalar fallback, and the boxes left over from the wide loops.
+	for (; i < count; i++) {
+		if (p_min_x[i] <= query_max_x && query_min_x <= p_max_x[i] && p_min_y[i] <= query_max_y && query_min_y <= p_max_y[i]) {
+			p_out->push_back(i);
+		}
+	}
+	return (int)p_out->size();
+}
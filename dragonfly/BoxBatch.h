@@ -0,0 +1,45 @@
+/**
+	@file BoxBatch.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __BOX_BATCH_H__
+#define __BOX_BATCH_H__
+
+// System includes.
+#include <vector>
+
+// Engine includes.
+#include "Aabb.h"
+#include "Box.h"
+
+namespace df {
+
+	// Boxes packed as separate min/max coordinate arrays, for testing many at once.
+	class BoxBatch {
+
+	private:
+		std::vector<float> m_min_x, m_min_y; // Upper left corners.
+		std::vector<float> m_max_x, m_max_y; // Lower right corners.
+	public:
+		// Remove all boxes (keeping storage).
+		void clear();
+
+		// Add box. Its index is the number of boxes added before it.
+		void add(const Box& box);
+		void add(const Aabb& box);
+
+		// Return number of boxes.
+		int getCount() const;
+
+		// Fill p_out (cleared first) with indices, in increasing order, of boxes intersecting query.
+		// Boxes that only touch intersect, as with boxIntersectsBox().
+		// Tests 8 boxes at a time with AVX, 4 with SSE, else one at a time.
+		// Return number found.
+		int intersect(const Box& query, std::vector<int>* p_out) const;
+		int intersect(const Aabb& query, std::vector<int>* p_out) const;
+	};
+
+} // end of namespace df
+#endif // __BOX_BATCH_H__
@@ -7,25 +7,33 @@
 #include "Button.h"
 
 // Engine includes.
+#include "DisplayManager.h"
+#include "InputManager.h"
 #include "utility.h"
 
 df::Button::Button() {
 	m_highlight_color = df::COLOR_DEFAULT;
 	m_default_color = df::COLOR_DEFAULT;
+	IM.addInteractive(this);
+}
+
+df::Button::~Button() {
+	IM.removeInteractive(this);
 }
 
 int df::Button::eventHandler(const df::Event* p_e) {
 	if (p_e->getType() != df::MSE_EVENT) {
-		return 0;
+		return df::ViewObject::eventHandler(p_e);
 	}
-	const df::EventMouse* p_me = dynamic_cast<const df::EventMouse*>(p_e);
-	if (mouseOverButton(p_me)) {
-		setColor(m_highlight_color);
-		if (p_me->getMouseAction() == df::EventMouseAction::CLICKED) {
-			callback();
-		}
+	const df::EventMouse* p_me = static_cast<const df::EventMouse*>(p_e);
+	if (!mouseOverButton(p_me)) {
+		setColor(m_default_color);
+		return 1;
+	}
+	setColor(m_highlight_color);
+	if (p_me->getMouseAction() == df::EventMouseAction::CLICKED) {
+		callback();
 	}
-	setColor(m_default_color);
 	return 1;
 }
 
@@ -46,11 +54,5 @@ df::Color df::Button::setDefaultColor() const {
 }
 
 bool df::Button::mouseOverButton(const df::EventMouse* p_e) const {
-	int width = getViewString().length(), height = 1;
-	if (getBorder()) {
-		width += 4;
-		height += 2;
-	}
-	df::Box b(df::Vector(getPosition().getX() - width / 2, getPosition().getY() - height - 2), width, height);
-	return df::boxContainsPosition(b, p_e->getMousePosition());
+	return df::boxContainsPosition(getScreenBox(), df::pixelsToSpaces(p_e->getMousePosition()));
 }
\ No newline at end of file
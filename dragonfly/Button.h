@@ -17,9 +17,14 @@ namespace df {
 		Color m_highlight_color; // Color when highlighted.
 		Color m_default_color; // Color when not highlighted.
 	public:
+		// Add Button to the InputManager's interactive index.
 		Button();
 
-		// Handle "mouse" events.
+		// Remove Button from the InputManager's interactive index.
+		~Button();
+
+		// Handle "mouse" events (sent by the InputManager when over or leaving Button).
+		// Other events go to ViewObject.
 		// Return 0 if ignored, else 1.
 		int eventHandler(const Event* p_e);
 
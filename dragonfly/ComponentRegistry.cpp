@@ -0,0 +1,76 @@
+/**
+	Component membership for WorldManager systems.
+	@file ComponentRegistry.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "ComponentRegistry.h"
+
+// Engine includes.
+#include "Object.h"
+
+df::ComponentRegistry::ComponentRegistry() {
+}
+
+void df::ComponentRegistry::add(df::Object* p_o, df::Component component) {
+	const int handle_index = p_o->getHandle().getIndex();
+	std::vector<int>& index = m_index[(int)component];
+	if (handle_index >= (int)index.size()) {
+		index.resize(handle_index + 1, -1);
+	}
+	if (index[handle_index] != -1) {
+		return; // Already a member.
+	}
+	std::vector<df::Object*>& members = m_members[(int)component];
+	index[handle_index] = (int)members.size();
+	members.push_back(p_o);
+}
+
+void df::ComponentRegistry::remove(const df::Object* p_o, df::Component component) {
+	const int handle_index = p_o->getHandle().getIndex();
+	std::vector<int>& index = m_index[(int)component];
+	if (handle_index >= (int)index.size() || index[handle_index] == -1) {
+		return; // Not a member.
+	}
+	std::vector<df::Object*>& members = m_members[(int)component];
+	const int at = index[handle_index];
+	members[at] = members.back();
+	index[members[at]->getHandle().getIndex()] = at;
+	members.pop_back();
+	index[handle_index] = -1;
+}
+
+void df::ComponentRegistry::removeAll(const df::Object* p_o) {
+	for (int i = 0; i < df::COMPONENT_COUNT; i++) {
+		remove(p_o, (df::Component)i);
+	}
+}
+
+void df::ComponentRegistry::removeMarked() {
+	for (int i = 0; i < df::COMPONENT_COUNT; i++) {
+		std::vector<df::Object*>& members = m_members[i];
+		std::vector<int>& index = m_index[i];
+		size_t kept = 0;
+		for (size_t j = 0; j < members.size(); j++) {
+			df::Object* p_o = members[j];
+			if (p_o->isMarkedForDelete()) {
+				index[p_o->getHandle().getIndex()] = -1;
+				continue;
+			}
+			members[kept] = p_o;
+			index[p_o->getHandle().getIndex()] = (int)kept;
+			kept++;
+		}
+		members.resize(kept);
+	}
+}
+
+bool df::ComponentRegistry::has(const df::Object* p_o, df::Component component) const {
+	const int handle_index = p_o->getHandle().getIndex();
+	const std::vector<int>& index = m_index[(int)component];
+	return handle_index < (int)index.size() && index[handle_index] != -1;
+}
+
+const std::vector<df::Object*>& df::ComponentRegistry::members(df::Component component) const {
+	return m_members[(int)component];
+}
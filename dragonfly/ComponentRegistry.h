@@ -0,0 +1,61 @@
+/**
+	@file ComponentRegistry.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __COMPONENT_REGISTRY_H__
+#define __COMPONENT_REGISTRY_H__
+
+// System includes.
+#include <vector>
+
+namespace df {
+
+	class Object;
+
+	// What an Object takes part in. Each WorldManager system only visits Objects with its component.
+	enum class Component {
+		GRAVITY,       // Affected by gravity (see Object::hasGravity()).
+		VELOCITY,      // Moving, or about to (non-zero velocity or gravity).
+		ANIMATED,      // Sprite has more than one frame to step through.
+		STEP_LISTENER, // Receives step events (see Object::registerInterest()).
+		AI,            // Has stepParallel() called (see Object::setParallelStep()).
+		TRIGGER,       // Region firing trigger events (see Trigger.h).
+	};
+	const int COMPONENT_COUNT = (int)Component::TRIGGER + 1;
+
+	// Dense list of member Objects for each component (sparse set keyed by Object handle index).
+	// Add, remove and has are O(1). Removing moves the last member into the gap, so order is not kept.
+	class ComponentRegistry {
+
+	private:
+		std::vector<Object*> m_members[COMPONENT_COUNT]; // Objects with each component.
+		std::vector<int> m_index[COMPONENT_COUNT];       // Handle index to position in m_members (-1 if not a member).
+		ComponentRegistry(ComponentRegistry const&);     // Don't allow copy.
+		void operator=(ComponentRegistry const&);        // Don't allow assignment.
+	public:
+		ComponentRegistry();
+
+		// Give Object component. Does nothing if it already has it.
+		void add(Object* p_o, Component component);
+
+		// Take component from Object. Does nothing if it doesn't have it.
+		void remove(const Object* p_o, Component component);
+
+		// Take all components from Object.
+		void removeAll(const Object* p_o);
+
+		// Take all components from Objects marked for delete (see Object::isMarkedForDelete()).
+		// One pass over each list.
+		void removeMarked();
+
+		// Return true if Object has component.
+		bool has(const Object* p_o, Component component) const;
+
+		// Return all Objects with component. Copy before iterating if handlers may change membership.
+		const std::vector<Object*>& members(Component component) const;
+	};
+
+} // end of namespace df
+#endif // __COMPONENT_REGISTRY_H__
@@ -0,0 +1,61 @@
+/**
+	Contact pairs kept across steps.
+	@file ContactCache.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "ContactCache.h"
+
+df::ContactCache::ContactCache() {
+}
+
+uint64_t df::ContactCache::key(df::Handle a, df::Handle b) {
+	uint32_t low = (uint32_t)a.getIndex(), high = (uint32_t)b.getIndex();
+	if (low > high) {
+		uint32_t swap = low;
+		low = high;
+		high = swap;
+	}
+	return ((uint64_t)high << 32) | low;
+}
+
+bool df::ContactCache::touch(df::Handle mover, df::Handle other, df::Vector position, int step, int steps, df::CollisionPhase* p_phase) {
+	Contact& contact = m_contacts[key(mover, other)];
+	// A fresh entry has null handles. One for a deleted pair has stale ones, whose slots were reused.
+	const bool known = (contact.mover == mover && contact.other == other) || (contact.mover == other && contact.other == mover);
+	if (known && contact.last_step == step) {
+		return false;
+	}
+	*p_phase = known ? df::CollisionPhase::STAY : df::CollisionPhase::BEGIN;
+	if (!known) {
+		contact.expires = 0;
+	}
+	contact.mover = mover;
+	contact.other = other;
+	contact.position = position;
+	contact.last_step = step;
+	if (step + steps > contact.expires) {
+		contact.expires = step + steps;
+	}
+	return true;
+}
+
+void df::ContactCache::expire(int step, std::vector<df::Contact>* p_ended) {
+	for (auto it = m_contacts.begin(); it != m_contacts.end(); ) {
+		if (it->second.expires <= step) {
+			p_ended->push_back(it->second);
+			it = m_contacts.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+int df::ContactCache::getCount() const {
+	return (int)m_contacts.size();
+}
+
+void df::ContactCache::clear() {
+	m_contacts.clear();
+}
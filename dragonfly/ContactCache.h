@@ -0,0 +1,61 @@
+/**
+	@file ContactCache.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __CONTACT_CACHE_H__
+#define __CONTACT_CACHE_H__
+
+// System includes.
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Engine includes.
+#include "Handle.h"
+#include "Object.h"
+#include "Vector.h"
+
+namespace df {
+
+	// Pair of Objects in contact, as last seen by WorldManager::moveObject().
+	struct Contact {
+		Handle mover;   // Object that moved into the other.
+		Handle other;   // Object moved into.
+		Vector position; // Where mover ended up.
+		int last_step;  // Step contact was last seen.
+		int expires;    // Step by which contact must be seen again, else it ends.
+	};
+
+	// Contacts carried across steps, so each pair gets one begin, a stay per step and one end.
+	// Keyed by the pair of handle indices, whichever Object moved.
+	class ContactCache {
+
+	private:
+		std::unordered_map<uint64_t, Contact> m_contacts; // Current contacts.
+		ContactCache(ContactCache const&);  // Don't allow copy.
+		void operator=(ContactCache const&); // Don't allow assignment.
+
+		// Return key for pair, the same either way round.
+		static uint64_t key(Handle a, Handle b);
+	public:
+		ContactCache();
+
+		// Record that mover touched other at step. The contact lasts until step + steps.
+		// Set p_phase to BEGIN for a new contact, else STAY.
+		// Return false if the pair was already seen this step (no event to send).
+		bool touch(Handle mover, Handle other, Vector position, int step, int steps, CollisionPhase* p_phase);
+
+		// Remove contacts not seen again by step, adding them to p_ended (not cleared first).
+		void expire(int step, std::vector<Contact>* p_ended);
+
+		// Return number of current contacts.
+		int getCount() const;
+
+		// Forget all contacts without ending them.
+		void clear();
+	};
+
+} // end of namespace df
+#endif // __CONTACT_CACHE_H__
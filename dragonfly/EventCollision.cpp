@@ -12,13 +12,15 @@ df::EventCollision::EventCollision() {
 	m_pos = v;
 	m_p_obj1 = NULL;
 	m_p_obj2 = NULL;
+	m_phase = df::CollisionPhase::BEGIN;
 }
 
-df::EventCollision::EventCollision(df::Object* p_o1, df::Object* p_o2, df::Vector p) {
+df::EventCollision::EventCollision(df::Object* p_o1, df::Object* p_o2, df::Vector p, df::CollisionPhase phase) {
 	setType(df::COLLISION_EVENT);
 	m_pos = p;
 	m_p_obj1 = p_o1;
 	m_p_obj2 = p_o2;
+	m_phase = phase;
 }
 
 void df::EventCollision::setObject1(df::Object* p_new_o1) {
@@ -43,4 +45,12 @@ void df::EventCollision::setPosition(df::Vector new_pos) {
 
 df::Vector df::EventCollision::getPosition() const {
 	return m_pos;
-}
\ No newline at end of file
+}
+
+void df::EventCollision::setPhase(df::CollisionPhase new_phase) {
+	m_phase = new_phase;
+}
+
+df::CollisionPhase df::EventCollision::getPhase() const {
+	return m_phase;
+}
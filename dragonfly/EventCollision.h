@@ -20,14 +20,15 @@ namespace df {
 		Vector m_pos; // Where collision occurred.
 		Object* m_p_obj1; // Object moving, causing collision.
 		Object* m_p_obj2; // Object being collided with.
+		CollisionPhase m_phase; // Whether contact begins, stays or ends.
 
 	public:
-		// Create collision event at (0,0) with o1 and o2 NULL.
+		// Create collision event at (0,0) with o1 and o2 NULL, beginning contact.
 		EventCollision();
 
 		// Create collision event between o1 and o2 at position p.
 		// Object o1 "caused" collision by moving into object o2.
-		EventCollision(Object* p_o1, Object* p_o2, Vector p);
+		EventCollision(Object* p_o1, Object* p_o2, Vector p, CollisionPhase phase = CollisionPhase::BEGIN);
 
 		// Set object that caused collision.
 		void setObject1(Object* p_new_o1);
@@ -46,6 +47,12 @@ namespace df {
 
 		// Return position of collision.
 		Vector getPosition() const;
+
+		// Set phase of contact.
+		void setPhase(CollisionPhase new_phase);
+
+		// Return phase of contact. For END, position is where o1 was when the Objects last touched.
+		CollisionPhase getPhase() const;
 	};
 
 } // end of namespace df
@@ -34,6 +34,9 @@ namespace df {
 			A, B, C, D, E, F, G, H, I, J, K, L, M, N, O, P, Q, R, S, T, U, V, W, X, Y, Z,
 			NUM1, NUM2, NUM3, NUM4, NUM5, NUM6, NUM7, NUM8, NUM9, NUM0, BACKSPACE,
 		};
+
+		// Number of keys Dragonfly recognizes.
+		const int KEY_COUNT = (int)Key::BACKSPACE + 1;
 	} // end of namespace Keyboard
 
 	class EventKeyboard : public Event {
@@ -30,6 +30,9 @@ namespace df {
 			RIGHT,
 			MIDDLE,
 		};
+
+		// Number of mouse buttons Dragonfly recognizes.
+		const int BUTTON_COUNT = (int)Button::MIDDLE + 1;
 	} // end of namespace Mouse
 
 	class EventMouse : public Event {
@@ -9,11 +9,13 @@
 df::EventStep::EventStep() {
 	setType(df::STEP_EVENT);
 	m_step_count = 0;
+	m_step_delta = 1;
 }
 
 df::EventStep::EventStep(int init_step_count) {
 	setType(df::STEP_EVENT);
 	m_step_count = init_step_count;
+	m_step_delta = 1;
 }
 
 void df::EventStep::setStepCount(int new_step_count) {
@@ -22,4 +24,12 @@ void df::EventStep::setStepCount(int new_step_count) {
 
 int df::EventStep::getStepCount() const {
 	return m_step_count;
+}
+
+void df::EventStep::setStepDelta(int new_step_delta) {
+	m_step_delta = new_step_delta;
+}
+
+int df::EventStep::getStepDelta() const {
+	return m_step_delta;
 }
\ No newline at end of file
@@ -14,6 +14,7 @@ namespace df {
 	class EventStep : public Event {
 	private:
 		int m_step_count;  // Iteration number of game loop.
+		int m_step_delta;  // Steps this event stands for (more than 1 for Objects updated at a reduced rate).
 	public:
 		// Default constructor.
 		EventStep();
@@ -23,6 +24,10 @@ namespace df {
 		void setStepCount(int new_step_count);
 		// Get step count.
 		int getStepCount() const;
+		// Set number of steps this event stands for.
+		void setStepDelta(int new_step_delta);
+		// Get number of steps this event stands for (1 at full rate).
+		int getStepDelta() const;
 	};
 } // end of namespace df
 #endif // __EVENT_STEP_H__
@@ -0,0 +1,33 @@
+/**
+	Trigger event.
+	@file EventTrigger.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "EventTrigger.h"
+
+df::EventTrigger::EventTrigger() {
+	setType(df::TRIGGER_EVENT);
+	m_p_trigger = NULL;
+	m_p_object = NULL;
+	m_enter = true;
+}
+
+df::EventTrigger::EventTrigger(df::Object* p_trigger, df::Object* p_object, bool enter) {
+	setType(df::TRIGGER_EVENT);
+	m_p_trigger = p_trigger;
+	m_p_object = p_object;
+	m_enter = enter;
+}
+
+df::Object* df::EventTrigger::getTrigger() const {
+	return m_p_trigger;
+}
+
+df::Object* df::EventTrigger::getObject() const {
+	return m_p_object;
+}
+
+bool df::EventTrigger::isEnter() const {
+	return m_enter;
+}
@@ -0,0 +1,42 @@
+/**
+	@file EventTrigger.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __EVENT_TRIGGER_H__
+#define __EVENT_TRIGGER_H__
+
+#include "Event.h"
+#include "Object.h"
+
+namespace df {
+
+	const std::string TRIGGER_EVENT = "df::trigger";
+
+	class EventTrigger : public Event {
+
+	private:
+		Object* m_p_trigger; // Trigger entered or left.
+		Object* m_p_object;  // Object entering or leaving.
+		bool m_enter;        // True if entering, false if leaving.
+
+	public:
+		// Create trigger event with trigger and object NULL, entering.
+		EventTrigger();
+
+		// Create trigger event for Object entering (or leaving) trigger.
+		EventTrigger(Object* p_trigger, Object* p_object, bool enter);
+
+		// Return trigger entered or left.
+		Object* getTrigger() const;
+
+		// Return Object entering or leaving.
+		Object* getObject() const;
+
+		// Return true if Object entered trigger, false if it left.
+		bool isEnter() const;
+	};
+
+} // end of namespace df
+#endif // __EVENT_TRIGGER_H__
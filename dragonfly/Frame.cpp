@@ -64,15 +64,19 @@ char df::Frame::getTransparency() const {
 }
 
 int df::Frame::draw(df::Vector position, df::Color color, char transparent) const {
+	return df::drawGlyphs(m_frame_str.data(), m_width, m_height, position, color, transparent);
+}
+
+int df::drawGlyphs(const char* p_glyphs, int width, int height, df::Vector position, df::Color color, char transparent) {
 	if (!DM.getWindow()) {
 		LM.writeLog("ERROR", "Frame", "Cannot draw. No window.");
 		return -1;
 	}
-	for (int y = 0; y < m_height; y++) {
-		for (int x = 0; x < m_width; x++) {
-			if (!transparent || m_frame_str[x + (y * getWidth())] != transparent) {
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			if (!transparent || p_glyphs[x + (y * width)] != transparent) {
 				// Only draw if the character is not the transparent character or there is no transparent character.
-				if (DM.drawCh(position + df::Vector(x, y), m_frame_str[x + (y * getWidth())], color) == -1) {
+				if (DM.drawCh(position + df::Vector(x, y), p_glyphs[x + (y * width)], color) == -1) {
 					LM.writeLog("ERROR", "Frame", "Error drawing char %d %d.", x, y);
 					return -1;
 				}
@@ -65,5 +65,10 @@ namespace df {
 		int draw(Vector position, Color color, char transparent) const;
 	};
 
+	// Draw a block of width x height characters (row major) at position (x,y) with color.
+	// Characters equal to transparent are skipped (0 means none).
+	// Return 0 if ok, else -1.
+	int drawGlyphs(const char* p_glyphs, int width, int height, Vector position, Color color, char transparent);
+
 } // end of namespace df
 #endif //__FRAME_H__
@@ -10,11 +10,12 @@
 #include "DisplayManager.h"
 #include "../FloorManager.h"
 #include "InputManager.h"
+#include "JobManager.h"
 #include "LogManager.h"
+#include "ResourceManager.h"
 #include "WorldManager.h"
 #include "Clock.h"
 #include "ObjectListIterator.h"
-#include "EventStep.h"
 #include "utility.h"
 
 // System includes.
@@ -65,6 +66,10 @@ int df::GameManager::startUp() {
 		writeLog("ERROR", "Error starting InputManager.");
 		return -1;
 	}
+	if (JM.startUp()) {
+		writeLog("ERROR", "Error starting JobManager.");
+		return -1;
+	}
 	df::Manager::startUp();
 	return 0;
 }
@@ -73,6 +78,7 @@ void df::GameManager::shutDown() {
 	m_game_over = true;
 	timeEndPeriod(1);
 	writeLog("", "Stopping managers.");
+	JM.shutDown();
 	IM.shutDown();
 	WM.shutDown();
 	DM.shutDown();
@@ -97,16 +103,17 @@ void df::GameManager::run() {
 
 		clock.delta(); // Reset frame clock.
 
+		if (RM.isStarted()) {
+			RM.update(); // Register resources that finished loading in the background.
+		}
+
 		if (m_enable_input) {
 			IM.getInput(); // Poll and dispatch input events.
 		}
-		WM.update(m_step_count); // Update world objects and delete pending objects.
+		WM.update(m_step_count); // Update world objects, dispatch step event and delete pending objects.
 		
 		WM.draw(); // Redraw frame.
 		DM.swapBuffers(); // Prepare buffer for new frame.
-		
-		EventStep s;
-		WM.onEvent(&s); // Dispatch step event.
 
 		// Pause for a small amount of time to run game at 30 fps.
 		int loop_time = clock.split();
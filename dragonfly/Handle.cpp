@@ -0,0 +1,44 @@
+/**
+	Generational Object handles.
+	@file Handle.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "Handle.h"
+
+// System includes.
+#include <cstddef>
+
+df::HandleTable::HandleTable() {
+}
+
+df::Handle df::HandleTable::issue(df::Object* p_o) {
+	int index;
+	if (m_free.empty()) {
+		index = (int)m_objects.size();
+		m_objects.push_back(NULL);
+		m_generations.push_back(1);
+	}
+	else {
+		index = m_free.back();
+		m_free.pop_back();
+	}
+	m_objects[index] = p_o;
+	return df::Handle(index, m_generations[index]);
+}
+
+void df::HandleTable::release(df::Handle handle) {
+	if (!resolve(handle)) {
+		return;
+	}
+	m_objects[handle.getIndex()] = NULL;
+	m_generations[handle.getIndex()]++;
+	m_free.push_back(handle.getIndex());
+}
+
+df::Object* df::HandleTable::resolve(df::Handle handle) const {
+	if (handle.getIndex() < 0 || handle.getIndex() >= (int)m_objects.size() || m_generations[handle.getIndex()] != handle.getGeneration()) {
+		return NULL;
+	}
+	return m_objects[handle.getIndex()];
+}
@@ -0,0 +1,65 @@
+/**
+	@file Handle.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __HANDLE_H__
+#define __HANDLE_H__
+
+// System includes.
+#include <cstdint>
+#include <vector>
+
+namespace df {
+
+	class Object;
+
+	// Reference to an Object that is safe to hold across frames.
+	// Resolves (see WorldManager::getObject()) to NULL once the Object is deleted.
+	class Handle {
+	private:
+		int m_index;          // Slot in HandleTable (-1 if never issued).
+		uint32_t m_generation; // Generation of slot when issued.
+	public:
+		// Create null handle.
+		Handle() : m_index(-1), m_generation(0) {}
+
+		Handle(int index, uint32_t generation) : m_index(index), m_generation(generation) {}
+
+		int getIndex() const { return m_index; }
+
+		uint32_t getGeneration() const { return m_generation; }
+
+		// Return true if handle was issued to an Object (which may since have been deleted).
+		bool isValid() const { return m_index >= 0; }
+
+		bool operator==(const Handle& other) const { return m_index == other.m_index && m_generation == other.m_generation; }
+		bool operator!=(const Handle& other) const { return !(*this == other); }
+	};
+
+	// Slot map from Handle to Object.
+	// Releasing a slot bumps its generation, so old handles to it stop resolving.
+	class HandleTable {
+
+	private:
+		std::vector<Object*> m_objects;      // Object in each slot (NULL if free).
+		std::vector<uint32_t> m_generations; // Current generation of each slot.
+		std::vector<int> m_free;             // Free slots.
+		HandleTable(HandleTable const&);     // Don't allow copy.
+		void operator=(HandleTable const&);  // Don't allow assignment.
+	public:
+		HandleTable();
+
+		// Issue handle for Object.
+		Handle issue(Object* p_o);
+
+		// Stop handle from resolving and free its slot. Does nothing if handle is stale.
+		void release(Handle handle);
+
+		// Return Object for handle, else NULL if deleted or never issued. O(1).
+		Object* resolve(Handle handle) const;
+	};
+
+} // end of namespace df
+#endif // __HANDLE_H__
@@ -12,13 +12,50 @@
 #include "DisplayManager.h"
 #include "LogManager.h"
 #include "WorldManager.h"
+#include "ViewObject.h"
+#include "utility.h"
+
+// System includes.
+#include <cstring>
+
+// Return true if record read from a replay is in range: a known type, and for keys and
+// buttons a code that is undefined (-1) or fits the snapshot bitsets.
+static bool isValidRecord(const df::InputRecord& record) {
+	switch (record.type) {
+	case df::InputRecordType::KEY_PRESSED:
+	case df::InputRecordType::KEY_RELEASED:
+		return record.code >= -1 && record.code < df::Keyboard::KEY_COUNT;
+	case df::InputRecordType::BUTTON_PRESSED:
+	case df::InputRecordType::BUTTON_RELEASED:
+		return record.code >= -1 && record.code < df::Mouse::BUTTON_COUNT;
+	case df::InputRecordType::MOUSE_MOVED:
+	case df::InputRecordType::LOST_FOCUS:
+		return true;
+	default:
+		return false;
+	}
+}
 
 df::InputManager::InputManager() {
 	setType("InputManager");
+	p_hover = NULL;
+	m_mouse_moved = false;
+	m_index_current = false;
+	m_recording = false;
+	m_replaying = false;
+	m_seed = 0;
+	m_frame_count = 0;
 }
 
 df::InputManager::InputManager(InputManager const&) {
 	setType("InputManager");
+	p_hover = NULL;
+	m_mouse_moved = false;
+	m_index_current = false;
+	m_recording = false;
+	m_replaying = false;
+	m_seed = 0;
+	m_frame_count = 0;
 }
 
 void df::InputManager::operator=(InputManager const&) {
@@ -48,411 +85,459 @@ int df::InputManager::startUp() {
 }
 
 void df::InputManager::shutDown() {
+	stopRecording();
+	stopReplay();
 	DM.getWindow()->setKeyRepeatEnabled(true); // Reenable repeat event dispatches.
 	df::Manager::shutDown();
 }
 
-void df::InputManager::getInput() {
-	// Map of SFML keys to Dragonfly keys
-	sf::Keyboard::Key sfKeys[] = {
-		sf::Keyboard::Key::Space,
-		sf::Keyboard::Key::Return,
-		sf::Keyboard::Key::Escape,
-		sf::Keyboard::Key::Tab,
-		sf::Keyboard::Key::Left,
-		sf::Keyboard::Key::Right,
-		sf::Keyboard::Key::Up,
-		sf::Keyboard::Key::Down,
-		sf::Keyboard::Key::Pause,
-		sf::Keyboard::Key::Subtract,
-		sf::Keyboard::Key::Add,
-		sf::Keyboard::Key::Tilde,
-		sf::Keyboard::Key::Period,
-		sf::Keyboard::Key::Comma,
-		sf::Keyboard::Key::Slash,
-		sf::Keyboard::Key::Equal,
-		sf::Keyboard::Key::BackSlash,
-		sf::Keyboard::Key::Multiply,
-		sf::Keyboard::Key::Quote,
-		sf::Keyboard::Key::SemiColon,
-		sf::Keyboard::Key::LControl,
-		sf::Keyboard::Key::RControl,
-		sf::Keyboard::Key::LShift,
-		sf::Keyboard::Key::RShift,
-		sf::Keyboard::Key::F1,
-		sf::Keyboard::Key::F2,
-		sf::Keyboard::Key::F3,
-		sf::Keyboard::Key::F4,
-		sf::Keyboard::Key::F5,
-		sf::Keyboard::Key::F6,
-		sf::Keyboard::Key::F7,
-		sf::Keyboard::Key::F8,
-		sf::Keyboard::Key::F9,
-		sf::Keyboard::Key::F10,
-		sf::Keyboard::Key::F11,
-		sf::Keyboard::Key::F12,
-		sf::Keyboard::Key::A,
-		sf::Keyboard::Key::B,
-		sf::Keyboard::Key::C,
-		sf::Keyboard::Key::D,
-		sf::Keyboard::Key::E,
-		sf::Keyboard::Key::F,
-		sf::Keyboard::Key::G,
-		sf::Keyboard::Key::H,
-		sf::Keyboard::Key::I,
-		sf::Keyboard::Key::J,
-		sf::Keyboard::Key::K,
-		sf::Keyboard::Key::L,
-		sf::Keyboard::Key::M,
-		sf::Keyboard::Key::N,
-		sf::Keyboard::Key::O,
-		sf::Keyboard::Key::P,
-		sf::Keyboard::Key::Q,
-		sf::Keyboard::Key::R,
-		sf::Keyboard::Key::S,
-		sf::Keyboard::Key::T,
-		sf::Keyboard::Key::U,
-		sf::Keyboard::Key::V,
-		sf::Keyboard::Key::W,
-		sf::Keyboard::Key::X,
-		sf::Keyboard::Key::Y,
-		sf::Keyboard::Key::Z,
-		sf::Keyboard::Key::Num1,
-		sf::Keyboard::Key::Num2,
-		sf::Keyboard::Key::Num3,
-		sf::Keyboard::Key::Num4,
-		sf::Keyboard::Key::Num5,
-		sf::Keyboard::Key::Num6,
-		sf::Keyboard::Key::Num7,
-		sf::Keyboard::Key::Num8,
-		sf::Keyboard::Key::Num9,
-		sf::Keyboard::Key::Num0,
-		sf::Keyboard::Key::BackSpace
+namespace {
+
+	// SFML key and the Dragonfly key it maps to.
+	struct KeyPair {
+		sf::Keyboard::Key sf_key;
+		df::Keyboard::Key df_key;
+	};
+
+	// Keys Dragonfly recognizes.
+	constexpr KeyPair KEY_PAIRS[] = {
+		{ sf::Keyboard::Key::Space, df::Keyboard::Key::SPACE },
+		{ sf::Keyboard::Key::Return, df::Keyboard::Key::RETURN },
+		{ sf::Keyboard::Key::Escape, df::Keyboard::Key::ESCAPE },
+		{ sf::Keyboard::Key::Tab, df::Keyboard::Key::TAB },
+		{ sf::Keyboard::Key::Left, df::Keyboard::Key::LEFTARROW },
+		{ sf::Keyboard::Key::Right, df::Keyboard::Key::RIGHTARROW },
+		{ sf::Keyboard::Key::Up, df::Keyboard::Key::UPARROW },
+		{ sf::Keyboard::Key::Down, df::Keyboard::Key::DOWNARROW },
+		{ sf::Keyboard::Key::Pause, df::Keyboard::Key::PAUSE },
+		{ sf::Keyboard::Key::Subtract, df::Keyboard::Key::MINUS },
+		{ sf::Keyboard::Key::Add, df::Keyboard::Key::PLUS },
+		{ sf::Keyboard::Key::Tilde, df::Keyboard::Key::TILDE },
+		{ sf::Keyboard::Key::Period, df::Keyboard::Key::PERIOD },
+		{ sf::Keyboard::Key::Comma, df::Keyboard::Key::COMMA },
+		{ sf::Keyboard::Key::Slash, df::Keyboard::Key::SLASH },
+		{ sf::Keyboard::Key::Equal, df::Keyboard::Key::EQUAL },
+		{ sf::Keyboard::Key::BackSlash, df::Keyboard::Key::BACKSLASH },
+		{ sf::Keyboard::Key::Multiply, df::Keyboard::Key::MULTIPLY },
+		{ sf::Keyboard::Key::Quote, df::Keyboard::Key::QUOTE },
+		{ sf::Keyboard::Key::SemiColon, df::Keyboard::Key::SEMICOLON },
+		{ sf::Keyboard::Key::LControl, df::Keyboard::Key::LEFTCONTROL },
+		{ sf::Keyboard::Key::RControl, df::Keyboard::Key::RIGHTCONTROL },
+		{ sf::Keyboard::Key::LShift, df::Keyboard::Key::LEFTSHIFT },
+		{ sf::Keyboard::Key::RShift, df::Keyboard::Key::RIGHTSHIFT },
+		{ sf::Keyboard::Key::F1, df::Keyboard::Key::F1 },
+		{ sf::Keyboard::Key::F2, df::Keyboard::Key::F2 },
+		{ sf::Keyboard::Key::F3, df::Keyboard::Key::F3 },
+		{ sf::Keyboard::Key::F4, df::Keyboard::Key::F4 },
+		{ sf::Keyboard::Key::F5, df::Keyboard::Key::F5 },
+		{ sf::Keyboard::Key::F6, df::Keyboard::Key::F6 },
+		{ sf::Keyboard::Key::F7, df::Keyboard::Key::F7 },
+		{ sf::Keyboard::Key::F8, df::Keyboard::Key::F8 },
+		{ sf::Keyboard::Key::F9, df::Keyboard::Key::F9 },
+		{ sf::Keyboard::Key::F10, df::Keyboard::Key::F10 },
+		{ sf::Keyboard::Key::F11, df::Keyboard::Key::F11 },
+		{ sf::Keyboard::Key::F12, df::Keyboard::Key::F12 },
+		{ sf::Keyboard::Key::A, df::Keyboard::Key::A },
+		{ sf::Keyboard::Key::B, df::Keyboard::Key::B },
+		{ sf::Keyboard::Key::C, df::Keyboard::Key::C },
+		{ sf::Keyboard::Key::D, df::Keyboard::Key::D },
+		{ sf::Keyboard::Key::E, df::Keyboard::Key::E },
+		{ sf::Keyboard::Key::F, df::Keyboard::Key::F },
+		{ sf::Keyboard::Key::G, df::Keyboard::Key::G },
+		{ sf::Keyboard::Key::H, df::Keyboard::Key::H },
+		{ sf::Keyboard::Key::I, df::Keyboard::Key::I },
+		{ sf::Keyboard::Key::J, df::Keyboard::Key::J },
+		{ sf::Keyboard::Key::K, df::Keyboard::Key::K },
+		{ sf::Keyboard::Key::L, df::Keyboard::Key::L },
+		{ sf::Keyboard::Key::M, df::Keyboard::Key::M },
+		{ sf::Keyboard::Key::N, df::Keyboard::Key::N },
+		{ sf::Keyboard::Key::O, df::Keyboard::Key::O },
+		{ sf::Keyboard::Key::P, df::Keyboard::Key::P },
+		{ sf::Keyboard::Key::Q, df::Keyboard::Key::Q },
+		{ sf::Keyboard::Key::R, df::Keyboard::Key::R },
+		{ sf::Keyboard::Key::S, df::Keyboard::Key::S },
+		{ sf::Keyboard::Key::T, df::Keyboard::Key::T },
+		{ sf::Keyboard::Key::U, df::Keyboard::Key::U },
+		{ sf::Keyboard::Key::V, df::Keyboard::Key::V },
+		{ sf::Keyboard::Key::W, df::Keyboard::Key::W },
+		{ sf::Keyboard::Key::X, df::Keyboard::Key::X },
+		{ sf::Keyboard::Key::Y, df::Keyboard::Key::Y },
+		{ sf::Keyboard::Key::Z, df::Keyboard::Key::Z },
+		{ sf::Keyboard::Key::Num1, df::Keyboard::Key::NUM1 },
+		{ sf::Keyboard::Key::Num2, df::Keyboard::Key::NUM2 },
+		{ sf::Keyboard::Key::Num3, df::Keyboard::Key::NUM3 },
+		{ sf::Keyboard::Key::Num4, df::Keyboard::Key::NUM4 },
+		{ sf::Keyboard::Key::Num5, df::Keyboard::Key::NUM5 },
+		{ sf::Keyboard::Key::Num6, df::Keyboard::Key::NUM6 },
+		{ sf::Keyboard::Key::Num7, df::Keyboard::Key::NUM7 },
+		{ sf::Keyboard::Key::Num8, df::Keyboard::Key::NUM8 },
+		{ sf::Keyboard::Key::Num9, df::Keyboard::Key::NUM9 },
+		{ sf::Keyboard::Key::Num0, df::Keyboard::Key::NUM0 },
+		{ sf::Keyboard::Key::BackSpace, df::Keyboard::Key::BACKSPACE },
 	};
-	df::Keyboard::Key dfKeys[] = {
-		df::Keyboard::Key::SPACE,
-		df::Keyboard::Key::RETURN,
-		df::Keyboard::Key::ESCAPE,
-		df::Keyboard::Key::TAB,
-		df::Keyboard::Key::LEFTARROW,
-		df::Keyboard::Key::RIGHTARROW,
-		df::Keyboard::Key::UPARROW,
-		df::Keyboard::Key::DOWNARROW,
-		df::Keyboard::Key::PAUSE,
-		df::Keyboard::Key::MINUS,
-		df::Keyboard::Key::PLUS,
-		df::Keyboard::Key::TILDE,
-		df::Keyboard::Key::PERIOD,
-		df::Keyboard::Key::COMMA,
-		df::Keyboard::Key::SLASH,
-		df::Keyboard::Key::EQUAL,
-		df::Keyboard::Key::BACKSLASH,
-		df::Keyboard::Key::MULTIPLY,
-		df::Keyboard::Key::QUOTE,
-		df::Keyboard::Key::SEMICOLON,
-		df::Keyboard::Key::LEFTCONTROL,
-		df::Keyboard::Key::RIGHTCONTROL,
-		df::Keyboard::Key::LEFTSHIFT,
-		df::Keyboard::Key::RIGHTSHIFT,
-		df::Keyboard::Key::F1,
-		df::Keyboard::Key::F2,
-		df::Keyboard::Key::F3,
-		df::Keyboard::Key::F4,
-		df::Keyboard::Key::F5,
-		df::Keyboard::Key::F6,
-		df::Keyboard::Key::F7,
-		df::Keyboard::Key::F8,
-		df::Keyboard::Key::F9,
-		df::Keyboard::Key::F10,
-		df::Keyboard::Key::F11,
-		df::Keyboard::Key::F12,
-		df::Keyboard::Key::A,
-		df::Keyboard::Key::B,
-		df::Keyboard::Key::C,
-		df::Keyboard::Key::D,
-		df::Keyboard::Key::E,
-		df::Keyboard::Key::F,
-		df::Keyboard::Key::G,
-		df::Keyboard::Key::H,
-		df::Keyboard::Key::I,
-		df::Keyboard::Key::J,
-		df::Keyboard::Key::K,
-		df::Keyboard::Key::L,
-		df::Keyboard::Key::M,
-		df::Keyboard::Key::N,
-		df::Keyboard::Key::O,
-		df::Keyboard::Key::P,
-		df::Keyboard::Key::Q,
-		df::Keyboard::Key::R,
-		df::Keyboard::Key::S,
-		df::Keyboard::Key::T,
-		df::Keyboard::Key::U,
-		df::Keyboard::Key::V,
-		df::Keyboard::Key::W,
-		df::Keyboard::Key::X,
-		df::Keyboard::Key::Y,
-		df::Keyboard::Key::Z,
-		df::Keyboard::Key::NUM1,
-		df::Keyboard::Key::NUM2,
-		df::Keyboard::Key::NUM3,
-		df::Keyboard::Key::NUM4,
-		df::Keyboard::Key::NUM5,
-		df::Keyboard::Key::NUM6,
-		df::Keyboard::Key::NUM7,
-		df::Keyboard::Key::NUM8,
-		df::Keyboard::Key::NUM9,
-		df::Keyboard::Key::NUM0,
-		df::Keyboard::Key::BACKSPACE
+
+	// SFML key code to Dragonfly key, indexed directly by SFML key code.
+	struct KeyMap {
+		df::Keyboard::Key df_key[sf::Keyboard::KeyCount];
 	};
 
+	constexpr KeyMap buildKeyMap() {
+		KeyMap map{};
+		for (int i = 0; i < sf::Keyboard::KeyCount; i++) {
+			map.df_key[i] = df::Keyboard::Key::UNDEFINED_KEY;
+		}
+		for (size_t i = 0; i < sizeof(KEY_PAIRS) / sizeof(KEY_PAIRS[0]); i++) {
+			map.df_key[KEY_PAIRS[i].sf_key] = KEY_PAIRS[i].df_key;
+		}
+		return map;
+	}
+
+	constexpr KeyMap KEY_MAP = buildKeyMap();
+
+	// Return Dragonfly key for SFML key code (UNDEFINED_KEY if not recognized).
+	df::Keyboard::Key toDfKey(sf::Keyboard::Key code) {
+		if (code < 0 || code >= sf::Keyboard::KeyCount) {
+			return df::Keyboard::Key::UNDEFINED_KEY;
+		}
+		return KEY_MAP.df_key[code];
+	}
+
+	// Return Dragonfly button for SFML button (UNDEFINED_MOUSE_BUTTON if not recognized).
+	df::Mouse::Button toDfButton(sf::Mouse::Button button) {
+		switch (button) {
+		case sf::Mouse::Left:
+			return df::Mouse::Button::LEFT;
+		case sf::Mouse::Middle:
+			return df::Mouse::Button::MIDDLE;
+		case sf::Mouse::Right:
+			return df::Mouse::Button::RIGHT;
+		default:
+			return df::Mouse::Button::UNDEFINED_MOUSE_BUTTON;
+		}
+	}
+}
+
+void df::InputManager::getInput() {
+	m_snapshot.beginFrame();
+	m_frame.clear();
+
+	// While replaying the window is still polled so it stays responsive, but its input is ignored.
+	pollWindow(!m_replaying);
+	if (m_replaying && readFrame() == -1) {
+		writeLog("ALERT", "Replay finished after %d frames.", m_frame_count);
+		stopReplay();
+	}
+
+	m_mouse_moved = false;
+	m_index_current = false;
+	for (size_t i = 0; i < m_frame.size(); i++) {
+		applyRecord(m_frame[i]);
+	}
+	if (m_mouse_moved) {
+		dispatchMouseMove();
+	}
+
+	if (m_recording) {
+		uint16_t count = (uint16_t)m_frame.size();
+		m_record_file.write((const char*)&count, sizeof(count));
+		if (count > 0) {
+			m_record_file.write((const char*)m_frame.data(), sizeof(df::InputRecord) * count);
+		}
+		if (!m_record_file.good()) {
+			writeLog("ERROR", "Error writing input recording. Recording stopped.");
+			stopRecording();
+		}
+	}
+	m_frame_count++;
+}
+
+void df::InputManager::pollWindow(bool keep_input) {
 	sf::Event event;
 	while (DM.getWindow()->pollEvent(event)) { // Poll for input events.
-		// Key press event.
-		if (event.type == sf::Event::KeyPressed) {
-			df::EventKeyboard eventKeyboard;
-			eventKeyboard.setKeyboardAction(df::EventKeyboardAction::KEY_PRESSED);
-
-			for(int i = 0; i < sizeof(dfKeys) / sizeof(dfKeys[0]); i++) {
-				if(sfKeys[i] == event.key.code) {
-					eventKeyboard.setKey(dfKeys[i]);
-				}
+		if (!keep_input) {
+			continue;
+		}
+		df::InputRecord record = { df::InputRecordType::LOST_FOCUS, 0, 0, 0 };
+		switch (event.type) {
+		case sf::Event::KeyPressed:
+		case sf::Event::KeyReleased:
+			record.type = event.type == sf::Event::KeyPressed ? df::InputRecordType::KEY_PRESSED : df::InputRecordType::KEY_RELEASED;
+			record.code = (int8_t)toDfKey(event.key.code);
+			break;
+		case sf::Event::MouseMoved:
+			record.type = df::InputRecordType::MOUSE_MOVED;
+			record.x = (int16_t)event.mouseMove.x;
+			record.y = (int16_t)event.mouseMove.y;
+			if (!m_frame.empty() && m_frame.back().type == df::InputRecordType::MOUSE_MOVED) {
+				m_frame.back() = record; // Only where the mouse ended up matters.
+				continue;
 			}
+			break;
+		case sf::Event::MouseButtonPressed:
+		case sf::Event::MouseButtonReleased:
+			record.type = event.type == sf::Event::MouseButtonPressed ? df::InputRecordType::BUTTON_PRESSED : df::InputRecordType::BUTTON_RELEASED;
+			record.code = (int8_t)toDfButton(event.mouseButton.button);
+			record.x = (int16_t)event.mouseButton.x;
+			record.y = (int16_t)event.mouseButton.y;
+			break;
+		case sf::Event::LostFocus:
+			break;
+		default:
+			continue; // Not input.
+		}
+		m_frame.push_back(record);
+	}
+}
 
-			WM.onEvent(&eventKeyboard);
+int df::InputManager::readFrame() {
+	uint16_t count = 0;
+	if (!m_replay_file.read((char*)&count, sizeof(count))) {
+		return -1;
+	}
+	m_frame.resize(count);
+	if (count > 0 && !m_replay_file.read((char*)m_frame.data(), sizeof(df::InputRecord) * count)) {
+		m_frame.clear();
+		return -1;
+	}
+	for (size_t i = 0; i < m_frame.size(); i++) {
+		if (!isValidRecord(m_frame[i])) {
+			writeLog("ERROR", "Corrupt replay: record %d of frame %d has type %d, code %d.", (int)i, m_frame_count, (int)m_frame[i].type, (int)m_frame[i].code);
+			m_frame.clear();
+			return -1;
 		}
-		// Key release event.
-		if (event.type == sf::Event::KeyReleased) {
-			df::EventKeyboard eventKeyboard;
-			eventKeyboard.setKeyboardAction(df::EventKeyboardAction::KEY_RELEASED);
-
-			for(int i = 0; i < sizeof(dfKeys) / sizeof(dfKeys[0]); i++) {
-				if(sfKeys[i] == event.key.code) {
-					eventKeyboard.setKey(dfKeys[i]);
-				}
-			}
+	}
+	return 0;
+}
 
-			WM.onEvent(&eventKeyboard);
+void df::InputManager::applyRecord(const df::InputRecord& record) {
+	switch (record.type) {
+	case df::InputRecordType::KEY_PRESSED:
+	case df::InputRecordType::KEY_RELEASED: {
+		df::Keyboard::Key key = (df::Keyboard::Key)record.code;
+		bool pressed = record.type == df::InputRecordType::KEY_PRESSED;
+		if (key != df::Keyboard::Key::UNDEFINED_KEY) {
+			m_snapshot.key_down[(int)key] = pressed;
+			if (pressed) {
+				m_snapshot.key_pressed[(int)key] = true;
+			}
+			else {
+				m_snapshot.key_released[(int)key] = true;
+			}
 		}
-		// Mouse move event.
-		if (event.type == sf::Event::MouseMoved) {
-			df::EventMouse eventMouse;
-			df::Vector v((float)event.mouseMove.x * DM.getHorizontalPixels(), (float)event.mouseMove.y * DM.getVerticalPixels());
-			eventMouse.setMouseAction(df::EventMouseAction::MOVED);
-			eventMouse.setMousePosition(v);
-			WM.onEvent(&eventMouse);
+		df::EventKeyboard eventKeyboard;
+		eventKeyboard.setKeyboardAction(pressed ? df::EventKeyboardAction::KEY_PRESSED : df::EventKeyboardAction::KEY_RELEASED);
+		eventKeyboard.setKey(key);
+		onEvent(&eventKeyboard);
+		break;
+	}
+	case df::InputRecordType::MOUSE_MOVED:
+		// Sent once per frame from getInput().
+		m_snapshot.mouse_position = df::Vector((float)record.x, (float)record.y);
+		m_mouse_moved = true;
+		break;
+	case df::InputRecordType::BUTTON_PRESSED: {
+		df::Mouse::Button button = (df::Mouse::Button)record.code;
+		if (button != df::Mouse::Button::UNDEFINED_MOUSE_BUTTON) {
+			m_snapshot.button_down[(int)button] = true;
+			m_snapshot.button_pressed[(int)button] = true;
 		}
-		// Mouse button press.
-		if (event.type == sf::Event::MouseButtonPressed) {
-			df::EventMouse eventMouse;
-			eventMouse.setMouseAction(df::EventMouseAction::CLICKED);
-			switch (event.mouseButton.button) {
-			case sf::Mouse::Left:
-				eventMouse.setMouseButton(df::Mouse::Button::LEFT);
-				break;
-			case sf::Mouse::Middle:
-				eventMouse.setMouseButton(df::Mouse::Button::MIDDLE);
-				break;
-			case sf::Mouse::Right:
-				eventMouse.setMouseButton(df::Mouse::Button::RIGHT);
-				break;
-			}
-			eventMouse.setMousePosition({(float)event.mouseButton.x, (float)event.mouseButton.y});
-			WM.onEvent(&eventMouse);
+		m_snapshot.mouse_position = df::Vector((float)record.x, (float)record.y);
+		df::EventMouse eventMouse;
+		eventMouse.setMouseAction(df::EventMouseAction::CLICKED);
+		eventMouse.setMouseButton(button);
+		eventMouse.setMousePosition(m_snapshot.mouse_position);
+		// Clicks on an interactive ViewObject go to it alone, others to interested Objects.
+		df::ViewObject* p_hit = hitTest(m_snapshot.mouse_position);
+		if (p_hit) {
+			p_hit->eventHandler(&eventMouse);
+		}
+		else {
+			onEvent(&eventMouse);
 		}
+		break;
 	}
-	
-
-	// Dispatch events for currently pressed keys.
-	for (int i = 0; i < sizeof(dfKeys) / sizeof(dfKeys[0]); i++) {
-		if (sf::Keyboard::isKeyPressed(sfKeys[i])) {
-			EventKeyboard eventKeyboard;
-			eventKeyboard.setKeyboardAction(df::EventKeyboardAction::KEY_DOWN);
-			eventKeyboard.setKey(dfKeys[i]);
-			WM.onEvent(&eventKeyboard);
+	case df::InputRecordType::BUTTON_RELEASED: {
+		df::Mouse::Button button = (df::Mouse::Button)record.code;
+		if (button != df::Mouse::Button::UNDEFINED_MOUSE_BUTTON) {
+			m_snapshot.button_down[(int)button] = false;
+			m_snapshot.button_released[(int)button] = true;
 		}
+		break;
 	}
-	// Map of SFML mouse buttons to Dragonfly mouse buttons
-	sf::Mouse::Button sfButtons[] = {
-		sf::Mouse::Button::Left,
-		sf::Mouse::Button::Middle,
-		sf::Mouse::Button::Right
-	};
-	df::Mouse::Button dfButtons[] = {
-		df::Mouse::Button::LEFT,
-		df::Mouse::Button::MIDDLE,
-		df::Mouse::Button::RIGHT
-	};
+	case df::InputRecordType::LOST_FOCUS:
+		// Releases happening while unfocused never arrive, so let go of everything.
+		m_snapshot.releaseAll();
+		break;
+	}
+}
 
-	// Dispatch events for currently pressed mouse buttons.
-	for (int i = 0; i < sizeof(dfButtons) / sizeof(dfButtons[0]); i++) {
-		if (sf::Mouse::isButtonPressed(sfButtons[i])) {
-			df::EventMouse eventMouse;
-			eventMouse.setMouseAction(df::EventMouseAction::PRESSED);
-			eventMouse.setMouseButton(dfButtons[i]);
-			WM.onEvent(&eventMouse);
+void df::InputManager::dispatchMouseMove() {
+	df::EventMouse eventMouse;
+	eventMouse.setMouseAction(df::EventMouseAction::MOVED);
+	eventMouse.setMousePosition(m_snapshot.mouse_position);
+	onEvent(&eventMouse);
+
+	// Interactive ViewObjects hear about moves that enter or leave them.
+	df::ViewObject* p_hit = hitTest(m_snapshot.mouse_position);
+	if (p_hover && p_hover != p_hit) {
+		p_hover->eventHandler(&eventMouse);
+	}
+	if (p_hit) {
+		p_hit->eventHandler(&eventMouse);
+	}
+	p_hover = p_hit;
+}
+
+df::ViewObject* df::InputManager::hitTest(df::Vector pixel_pos) {
+	if (!m_index_current) {
+		for (size_t i = 0; i < m_interactive.size(); i++) {
+			m_interactive[i].box = m_interactive[i].p_view_object->getScreenBox();
+		}
+		m_index_current = true;
+	}
+	df::Vector pos = df::pixelsToSpaces(pixel_pos);
+	df::ViewObject* p_hit = NULL;
+	for (size_t i = 0; i < m_interactive.size(); i++) {
+		df::ViewObject* p_vo = m_interactive[i].p_view_object;
+		if (!p_vo->isActive() || !p_vo->isVisible() || !df::boxContainsPosition(m_interactive[i].box, pos)) {
+			continue;
+		}
+		// Topmost wins. Later added wins ties, as it is drawn later.
+		if (!p_hit || p_vo->getAltitude() >= p_hit->getAltitude()) {
+			p_hit = p_vo;
 		}
 	}
+	return p_hit;
 }
 
-bool df::InputManager::isKeyDown(df::Keyboard::Key key) {
-	sf::Keyboard::Key sfKeys[] = {
-		sf::Keyboard::Key::Space,
-		sf::Keyboard::Key::Return,
-		sf::Keyboard::Key::Escape,
-		sf::Keyboard::Key::Tab,
-		sf::Keyboard::Key::Left,
-		sf::Keyboard::Key::Right,
-		sf::Keyboard::Key::Up,
-		sf::Keyboard::Key::Down,
-		sf::Keyboard::Key::Pause,
-		sf::Keyboard::Key::Subtract,
-		sf::Keyboard::Key::Add,
-		sf::Keyboard::Key::Tilde,
-		sf::Keyboard::Key::Period,
-		sf::Keyboard::Key::Comma,
-		sf::Keyboard::Key::Slash,
-		sf::Keyboard::Key::Equal,
-		sf::Keyboard::Key::BackSlash,
-		sf::Keyboard::Key::Multiply,
-		sf::Keyboard::Key::Quote,
-		sf::Keyboard::Key::SemiColon,
-		sf::Keyboard::Key::LControl,
-		sf::Keyboard::Key::RControl,
-		sf::Keyboard::Key::LShift,
-		sf::Keyboard::Key::RShift,
-		sf::Keyboard::Key::F1,
-		sf::Keyboard::Key::F2,
-		sf::Keyboard::Key::F3,
-		sf::Keyboard::Key::F4,
-		sf::Keyboard::Key::F5,
-		sf::Keyboard::Key::F6,
-		sf::Keyboard::Key::F7,
-		sf::Keyboard::Key::F8,
-		sf::Keyboard::Key::F9,
-		sf::Keyboard::Key::F10,
-		sf::Keyboard::Key::F11,
-		sf::Keyboard::Key::F12,
-		sf::Keyboard::Key::A,
-		sf::Keyboard::Key::B,
-		sf::Keyboard::Key::C,
-		sf::Keyboard::Key::D,
-		sf::Keyboard::Key::E,
-		sf::Keyboard::Key::F,
-		sf::Keyboard::Key::G,
-		sf::Keyboard::Key::H,
-		sf::Keyboard::Key::I,
-		sf::Keyboard::Key::J,
-		sf::Keyboard::Key::K,
-		sf::Keyboard::Key::L,
-		sf::Keyboard::Key::M,
-		sf::Keyboard::Key::N,
-		sf::Keyboard::Key::O,
-		sf::Keyboard::Key::P,
-		sf::Keyboard::Key::Q,
-		sf::Keyboard::Key::R,
-		sf::Keyboard::Key::S,
-		sf::Keyboard::Key::T,
-		sf::Keyboard::Key::U,
-		sf::Keyboard::Key::V,
-		sf::Keyboard::Key::W,
-		sf::Keyboard::Key::X,
-		sf::Keyboard::Key::Y,
-		sf::Keyboard::Key::Z,
-		sf::Keyboard::Key::Num1,
-		sf::Keyboard::Key::Num2,
-		sf::Keyboard::Key::Num3,
-		sf::Keyboard::Key::Num4,
-		sf::Keyboard::Key::Num5,
-		sf::Keyboard::Key::Num6,
-		sf::Keyboard::Key::Num7,
-		sf::Keyboard::Key::Num8,
-		sf::Keyboard::Key::Num9,
-		sf::Keyboard::Key::Num0,
-		sf::Keyboard::Key::BackSpace
-	};
-	df::Keyboard::Key dfKeys[] = {
-		df::Keyboard::Key::SPACE,
-		df::Keyboard::Key::RETURN,
-		df::Keyboard::Key::ESCAPE,
-		df::Keyboard::Key::TAB,
-		df::Keyboard::Key::LEFTARROW,
-		df::Keyboard::Key::RIGHTARROW,
-		df::Keyboard::Key::UPARROW,
-		df::Keyboard::Key::DOWNARROW,
-		df::Keyboard::Key::PAUSE,
-		df::Keyboard::Key::MINUS,
-		df::Keyboard::Key::PLUS,
-		df::Keyboard::Key::TILDE,
-		df::Keyboard::Key::PERIOD,
-		df::Keyboard::Key::COMMA,
-		df::Keyboard::Key::SLASH,
-		df::Keyboard::Key::EQUAL,
-		df::Keyboard::Key::BACKSLASH,
-		df::Keyboard::Key::MULTIPLY,
-		df::Keyboard::Key::QUOTE,
-		df::Keyboard::Key::SEMICOLON,
-		df::Keyboard::Key::LEFTCONTROL,
-		df::Keyboard::Key::RIGHTCONTROL,
-		df::Keyboard::Key::LEFTSHIFT,
-		df::Keyboard::Key::RIGHTSHIFT,
-		df::Keyboard::Key::F1,
-		df::Keyboard::Key::F2,
-		df::Keyboard::Key::F3,
-		df::Keyboard::Key::F4,
-		df::Keyboard::Key::F5,
-		df::Keyboard::Key::F6,
-		df::Keyboard::Key::F7,
-		df::Keyboard::Key::F8,
-		df::Keyboard::Key::F9,
-		df::Keyboard::Key::F10,
-		df::Keyboard::Key::F11,
-		df::Keyboard::Key::F12,
-		df::Keyboard::Key::A,
-		df::Keyboard::Key::B,
-		df::Keyboard::Key::C,
-		df::Keyboard::Key::D,
-		df::Keyboard::Key::E,
-		df::Keyboard::Key::F,
-		df::Keyboard::Key::G,
-		df::Keyboard::Key::H,
-		df::Keyboard::Key::I,
-		df::Keyboard::Key::J,
-		df::Keyboard::Key::K,
-		df::Keyboard::Key::L,
-		df::Keyboard::Key::M,
-		df::Keyboard::Key::N,
-		df::Keyboard::Key::O,
-		df::Keyboard::Key::P,
-		df::Keyboard::Key::Q,
-		df::Keyboard::Key::R,
-		df::Keyboard::Key::S,
-		df::Keyboard::Key::T,
-		df::Keyboard::Key::U,
-		df::Keyboard::Key::V,
-		df::Keyboard::Key::W,
-		df::Keyboard::Key::X,
-		df::Keyboard::Key::Y,
-		df::Keyboard::Key::Z,
-		df::Keyboard::Key::NUM1,
-		df::Keyboard::Key::NUM2,
-		df::Keyboard::Key::NUM3,
-		df::Keyboard::Key::NUM4,
-		df::Keyboard::Key::NUM5,
-		df::Keyboard::Key::NUM6,
-		df::Keyboard::Key::NUM7,
-		df::Keyboard::Key::NUM8,
-		df::Keyboard::Key::NUM9,
-		df::Keyboard::Key::NUM0,
-		df::Keyboard::Key::BACKSPACE
-	};
+int df::InputManager::addInteractive(df::ViewObject* p_view_object) {
+	for (size_t i = 0; i < m_interactive.size(); i++) {
+		if (m_interactive[i].p_view_object == p_view_object) {
+			return -1;
+		}
+	}
+	Interactive entry;
+	entry.p_view_object = p_view_object;
+	m_interactive.push_back(entry);
+	m_index_current = false;
+	return 0;
+}
 
-	for(int i = 0; i < sizeof(dfKeys) / sizeof(dfKeys[0]); i++) {
-		if(dfKeys[i] == key) {
-			return sf::Keyboard::isKeyPressed(sfKeys[i]);
+int df::InputManager::removeInteractive(df::ViewObject* p_view_object) {
+	for (size_t i = 0; i < m_interactive.size(); i++) {
+		if (m_interactive[i].p_view_object == p_view_object) {
+			m_interactive.erase(m_interactive.begin() + i);
+			if (p_hover == p_view_object) {
+				p_hover = NULL;
+			}
+			return 0;
 		}
 	}
+	return -1;
+}
+
+int df::InputManager::startRecording(std::string filename, unsigned long seed) {
+	stopRecording();
+	stopReplay();
+	m_record_file.open(filename.c_str(), std::ios::binary | std::ios::trunc);
+	if (!m_record_file.good()) {
+		writeLog("ERROR", "Error recording input. Cannot open '%s'.", filename.c_str());
+		m_record_file.close();
+		return -1;
+	}
+	df::InputRecordingHeader header;
+	memcpy(header.magic, df::INPUT_RECORDING_MAGIC, sizeof(header.magic));
+	header.version = df::INPUT_RECORDING_VERSION;
+	header.seed = (uint32_t)seed;
+	header.reserved = 0;
+	m_record_file.write((const char*)&header, sizeof(header));
+	m_seed = header.seed;
+	df::setRandomSeed(m_seed);
+	m_frame_count = 0;
+	m_recording = true;
+	writeLog("", "Recording input to '%s' (seed %lu).", filename.c_str(), m_seed);
+	return 0;
+}
+
+void df::InputManager::stopRecording() {
+	if (m_recording) {
+		writeLog("", "Recorded %d frames.", m_frame_count);
+	}
+	m_recording = false;
+	if (m_record_file.is_open()) {
+		m_record_file.close();
+	}
+}
+
+int df::InputManager::startReplay(std::string filename) {
+	stopRecording();
+	stopReplay();
+	m_replay_file.open(filename.c_str(), std::ios::binary);
+	df::InputRecordingHeader header;
+	if (!m_replay_file.read((char*)&header, sizeof(header))) {
+		writeLog("ERROR", "Error replaying input. Cannot read '%s'.", filename.c_str());
+		m_replay_file.close();
+		return -1;
+	}
+	if (memcmp(header.magic, df::INPUT_RECORDING_MAGIC, sizeof(header.magic)) != 0 || header.version != df::INPUT_RECORDING_VERSION) {
+		writeLog("ERROR", "Error replaying input. '%s' is not a version %u input recording.", filename.c_str(), df::INPUT_RECORDING_VERSION);
+		m_replay_file.close();
+		return -1;
+	}
+	m_seed = header.seed;
+	df::setRandomSeed(m_seed);
+	m_snapshot = df::InputSnapshot();
+	m_frame_count = 0;
+	m_replaying = true;
+	writeLog("", "Replaying input from '%s' (seed %lu).", filename.c_str(), m_seed);
+	return 0;
+}
+
+void df::InputManager::stopReplay() {
+	m_replaying = false;
+	if (m_replay_file.is_open()) {
+		m_replay_file.close();
+	}
+}
+
+bool df::InputManager::isRecording() const {
+	return m_recording;
+}
+
+bool df::InputManager::isReplaying() const {
+	return m_replaying;
+}
+
+unsigned long df::InputManager::getSeed() const {
+	return m_seed;
+}
+
+bool df::InputManager::isKeyDown(df::Keyboard::Key key) const {
+	return key != df::Keyboard::Key::UNDEFINED_KEY && m_snapshot.key_down[(int)key];
+}
+
+bool df::InputManager::wasKeyPressed(df::Keyboard::Key key) const {
+	return key != df::Keyboard::Key::UNDEFINED_KEY && m_snapshot.key_pressed[(int)key];
+}
+
+bool df::InputManager::wasKeyReleased(df::Keyboard::Key key) const {
+	return key != df::Keyboard::Key::UNDEFINED_KEY && m_snapshot.key_released[(int)key];
+}
+
+bool df::InputManager::isButtonDown(df::Mouse::Button button) const {
+	return button != df::Mouse::Button::UNDEFINED_MOUSE_BUTTON && m_snapshot.button_down[(int)button];
+}
+
+bool df::InputManager::wasButtonPressed(df::Mouse::Button button) const {
+	return button != df::Mouse::Button::UNDEFINED_MOUSE_BUTTON && m_snapshot.button_pressed[(int)button];
+}
+
+bool df::InputManager::wasButtonReleased(df::Mouse::Button button) const {
+	return button != df::Mouse::Button::UNDEFINED_MOUSE_BUTTON && m_snapshot.button_released[(int)button];
+}
 
-	return false;
+const df::InputSnapshot& df::InputManager::getSnapshot() const {
+	return m_snapshot;
 }
 
 bool df::InputManager::isValid(std::string event_name) const {
@@ -7,24 +7,68 @@
 #ifndef __INPUT_MANAGER_H__
 #define __INPUT_MANAGER_H__
 
+// System includes.
+#include <fstream>
+#include <vector>
+
+#include "Box.h"
 #include "Manager.h"
 
 #include "EventKeyboard.h"
+#include "EventMouse.h"
+#include "InputRecord.h"
+#include "InputSnapshot.h"
 
 // Two-letter acronym for easier access to manager.
 #define IM df::InputManager::getInstance()
 
 namespace df {
 
+	class ViewObject;
+
 	class InputManager : public Manager {
 
 	private:
 		InputManager();                     // Private since a singleton.
 		InputManager(InputManager const&);  // Don't allow copy.
 		void operator=(InputManager const&);// Don't allow assignment.
+		InputSnapshot m_snapshot;           // Keyboard and mouse state for this frame.
+		std::vector<InputRecord> m_frame;   // Raw input for this frame, in arrival order.
+		std::ofstream m_record_file;        // Recording being written.
+		std::ifstream m_replay_file;        // Recording being played back.
+		bool m_recording;                   // True if writing frames to m_record_file.
+		bool m_replaying;                   // True if reading frames from m_replay_file.
+		unsigned long m_seed;               // Random seed of the recording.
+		int m_frame_count;                  // Frames recorded or replayed so far.
+
+		// Interactive ViewObject and its screen box (in spaces) as of this frame.
+		struct Interactive {
+			ViewObject* p_view_object;
+			Box box;
+		};
+		std::vector<Interactive> m_interactive; // Index of ViewObjects that take clicks.
+		bool m_index_current;               // True if boxes in m_interactive are up to date this frame.
+		ViewObject* p_hover;                // Interactive ViewObject under the mouse (NULL if none).
+		bool m_mouse_moved;                 // True if the mouse moved this frame.
 		// Input manager only accepts keyboard and mouse events.
 		// Return false if not one of them
 		bool isValid(std::string event_name) const;
+
+		// Poll window events. Append input to m_frame if keep_input, else drop it.
+		void pollWindow(bool keep_input);
+
+		// Read next frame of the replay into m_frame.
+		// Return 0 if ok, else -1 (end of recording, or a record out of range).
+		int readFrame();
+
+		// Update snapshot from one raw input and dispatch its event (mouse moves are held back).
+		void applyRecord(const InputRecord& record);
+
+		// Send this frame's single mouse move to interested Objects and hovered ViewObjects.
+		void dispatchMouseMove();
+
+		// Return topmost active, visible interactive ViewObject containing pixel position (NULL if none).
+		ViewObject* hitTest(Vector pixel_pos);
 	public:
 		// Get the one and only instance of the InputManager.
 		static InputManager& getInstance();
@@ -36,11 +80,63 @@ namespace df {
 		// Revert back to normal window mode.
 		void shutDown();
 
-		// Get input from the keyboard and mouse.
-		// Pass event along to all interested Objects.
+		// Get input from the keyboard and mouse (or the replay) and update the snapshot.
+		// Pass keyboard events and at most one mouse move per frame to interested Objects.
+		// Clicks go to the interactive ViewObject under the mouse, else to interested Objects.
 		void getInput();
 
-		bool isKeyDown(df::Keyboard::Key key);
+		// Add ViewObject to the interactive index. It gets clicks on it and moves entering or leaving it.
+		// Return 0 if ok, else -1 (already added).
+		int addInteractive(ViewObject* p_view_object);
+
+		// Remove ViewObject from the interactive index.
+		// Return 0 if ok, else -1 (not found).
+		int removeInteractive(ViewObject* p_view_object);
+
+		// Record every frame's input from now on into file, and seed the random number generator.
+		// Return 0 if ok, else -1.
+		int startRecording(std::string filename, unsigned long seed);
+
+		// Stop recording and close file.
+		void stopRecording();
+
+		// Take input from recording in file instead of the window, and seed the random
+		// number generator with the recorded seed. Replay stops at the end of the recording.
+		// Return 0 if ok, else -1.
+		int startReplay(std::string filename);
+
+		// Stop replay and go back to window input.
+		void stopReplay();
+
+		// Return true if recording input.
+		bool isRecording() const;
+
+		// Return true if replaying input.
+		bool isReplaying() const;
+
+		// Return random seed of the current (or last) recording or replay.
+		unsigned long getSeed() const;
+
+		// Return true if key is held (as of the last getInput()).
+		bool isKeyDown(df::Keyboard::Key key) const;
+
+		// Return true if key went down during the last getInput().
+		bool wasKeyPressed(df::Keyboard::Key key) const;
+
+		// Return true if key went up during the last getInput().
+		bool wasKeyReleased(df::Keyboard::Key key) const;
+
+		// Return true if mouse button is held (as of the last getInput()).
+		bool isButtonDown(df::Mouse::Button button) const;
+
+		// Return true if mouse button went down during the last getInput().
+		bool wasButtonPressed(df::Mouse::Button button) const;
+
+		// Return true if mouse button went up during the last getInput().
+		bool wasButtonReleased(df::Mouse::Button button) const;
+
+		// Return keyboard and mouse state for this frame.
+		const InputSnapshot& getSnapshot() const;
 	};
 
 } // end of namespace df
@@ -0,0 +1,51 @@
+/**
+	@file InputRecord.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __INPUT_RECORD_H__
+#define __INPUT_RECORD_H__
+
+// System includes.
+#include <cstdint>
+
+namespace df {
+
+	// Magic bytes at the start of an input recording.
+	const char INPUT_RECORDING_MAGIC[4] = { 'D', 'F', 'I', 'R' };
+
+	// Input recording version. Bump when the layout changes.
+	const uint32_t INPUT_RECORDING_VERSION = 1;
+
+	// Header of an input recording. Stored little endian.
+	// Followed by one frame per game loop: a uint16_t record count and that many InputRecord.
+	struct InputRecordingHeader {
+		char magic[4];      // INPUT_RECORDING_MAGIC.
+		uint32_t version;   // INPUT_RECORDING_VERSION.
+		uint32_t seed;      // Random seed the session was started with.
+		uint32_t reserved;  // Always 0.
+	};
+
+	// Kinds of raw input kept in a recording.
+	enum class InputRecordType : uint8_t {
+		KEY_PRESSED,     // code is a Keyboard::Key.
+		KEY_RELEASED,    // code is a Keyboard::Key.
+		MOUSE_MOVED,     // x, y is window position.
+		BUTTON_PRESSED,  // code is a Mouse::Button, x, y is window position.
+		BUTTON_RELEASED, // code is a Mouse::Button.
+		LOST_FOCUS,      // Window lost focus.
+	};
+
+	// One raw input, in the order it arrived within its frame.
+	struct InputRecord {
+		InputRecordType type;
+		int8_t code;
+		int16_t x;
+		int16_t y;
+	};
+
+	static_assert(sizeof(InputRecord) == 6, "InputRecord is written to file as is.");
+
+} // end of namespace df
+#endif // __INPUT_RECORD_H__
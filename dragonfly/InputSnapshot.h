@@ -0,0 +1,49 @@
+/**
+	@file InputSnapshot.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __INPUT_SNAPSHOT_H__
+#define __INPUT_SNAPSHOT_H__
+
+// System includes.
+#include <bitset>
+
+// Engine includes.
+#include "EventKeyboard.h"
+#include "EventMouse.h"
+#include "Vector.h"
+
+namespace df {
+
+	// State of keyboard and mouse for one frame.
+	// Built once per frame by the InputManager from window events.
+	struct InputSnapshot {
+		std::bitset<Keyboard::KEY_COUNT> key_down;        // Keys held at end of frame.
+		std::bitset<Keyboard::KEY_COUNT> key_pressed;     // Keys that went down this frame.
+		std::bitset<Keyboard::KEY_COUNT> key_released;    // Keys that went up this frame.
+		std::bitset<Mouse::BUTTON_COUNT> button_down;     // Buttons held at end of frame.
+		std::bitset<Mouse::BUTTON_COUNT> button_pressed;  // Buttons that went down this frame.
+		std::bitset<Mouse::BUTTON_COUNT> button_released; // Buttons that went up this frame.
+		Vector mouse_position;                            // Last mouse position (pixels).
+
+		// Clear edge sets for the start of a new frame. Held state carries over.
+		void beginFrame() {
+			key_pressed.reset();
+			key_released.reset();
+			button_pressed.reset();
+			button_released.reset();
+		}
+
+		// Release everything held (e.g., window lost focus).
+		void releaseAll() {
+			key_released |= key_down;
+			key_down.reset();
+			button_released |= button_down;
+			button_down.reset();
+		}
+	};
+
+} // end of namespace df
+#endif // __INPUT_SNAPSHOT_H__
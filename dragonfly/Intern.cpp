@@ -0,0 +1,50 @@
+/**
+	String interning.
+	@file Intern.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "Intern.h"
+
+// System includes.
+#include <deque>
+#include <unordered_map>
+
+namespace {
+
+	// Function statics so interning from other statics' constructors is safe.
+	std::unordered_map<std::string, df::StringId>& idTable() {
+		static std::unordered_map<std::string, df::StringId> table;
+		return table;
+	}
+
+	// Deque, so references from internedString() stay valid as strings are added.
+	std::deque<std::string>& stringTable() {
+		static std::deque<std::string> table;
+		return table;
+	}
+}
+
+df::StringId df::intern(const std::string& str) {
+	std::unordered_map<std::string, df::StringId>& ids = idTable();
+	std::unordered_map<std::string, df::StringId>::const_iterator it = ids.find(str);
+	if (it != ids.end()) {
+		return it->second;
+	}
+	df::StringId id = (df::StringId)stringTable().size();
+	stringTable().push_back(str);
+	ids.emplace(str, id);
+	return id;
+}
+
+const std::string& df::internedString(df::StringId id) {
+	static const std::string empty;
+	if (id < 0 || id >= (df::StringId)stringTable().size()) {
+		return empty;
+	}
+	return stringTable()[id];
+}
+
+int df::getInternedCount() {
+	return (int)stringTable().size();
+}
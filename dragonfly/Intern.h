@@ -0,0 +1,29 @@
+/**
+	@file Intern.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __INTERN_H__
+#define __INTERN_H__
+
+// System includes.
+#include <string>
+
+namespace df {
+
+	// Small integer standing for a string. Equal strings get equal ids.
+	typedef int StringId;
+
+	// Return id for string, adding it to the table if new. Ids count up from 0.
+	// Not thread safe. Intern once (e.g., in a static) and compare ids after that.
+	StringId intern(const std::string& str);
+
+	// Return string for id ("" if id was never handed out).
+	const std::string& internedString(StringId id);
+
+	// Return number of strings interned so far.
+	int getInternedCount();
+
+} // end of namespace df
+#endif // __INTERN_H__
@@ -0,0 +1,266 @@
+/**
+	Job manager.
+	@file JobManager.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "JobManager.h"
+
+// Engine includes.
+#include "LogManager.h"
+
+namespace {
+
+	// Index of the calling thread's queue. Threads other than workers use the main thread's queue.
+	thread_local int t_queue_index = -1;
+}
+
+df::JobCounter::JobCounter() {
+	m_count = 0;
+}
+
+int df::JobCounter::getCount() const {
+	return m_count.load();
+}
+
+bool df::JobCounter::isDone() const {
+	return m_count.load() == 0;
+}
+
+df::JobManager::JobManager() {
+	setType("JobManager");
+	m_queued = 0;
+	m_stopping = false;
+}
+
+df::JobManager::JobManager(JobManager const&) {
+	setType("JobManager");
+	m_queued = 0;
+	m_stopping = false;
+}
+
+void df::JobManager::operator=(JobManager const&) {
+
+}
+
+df::JobManager& df::JobManager::getInstance() {
+	static JobManager jobManager;
+	return jobManager;
+}
+
+int df::JobManager::startUp() {
+	if (!LM.isStarted()) {
+		return -1;
+	}
+	// At least one worker, so background jobs always have a thread to run on.
+	int worker_count = (int)std::thread::hardware_concurrency() - 1;
+	if (worker_count < 1) {
+		worker_count = 1;
+	}
+	m_stopping = false;
+	m_queues.clear();
+	for (int i = 0; i <= worker_count; i++) {
+		m_queues.push_back(std::unique_ptr<Queue>(new Queue()));
+	}
+	for (int i = 0; i < worker_count; i++) {
+		m_workers.push_back(std::thread(&df::JobManager::work, this, i));
+	}
+	df::Manager::startUp();
+	writeLog("", "%d worker threads.", worker_count);
+	return 0;
+}
+
+void df::JobManager::shutDown() {
+	if (!isStarted()) {
+		return;
+	}
+	// Help drain what is left, then stop workers.
+	while (runOne(getWorkerCount(), true)) {
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (size_t i = 0; i < m_workers.size(); i++) {
+		m_workers[i].join();
+	}
+	m_workers.clear();
+	m_queues.clear();
+	df::Manager::shutDown();
+}
+
+int df::JobManager::getWorkerCount() const {
+	return (int)m_workers.size();
+}
+
+void df::JobManager::work(int index) {
+	t_queue_index = index;
+	while (true) {
+		if (runOne(index, true)) {
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(m_sleep_mutex);
+		m_wake.wait(lock, [this]() { return m_stopping.load() || m_queued.load() > 0; });
+		if (m_stopping && m_queued.load() == 0) {
+			return;
+		}
+	}
+}
+
+bool df::JobManager::runOne(int index, bool background) {
+	Entry entry;
+	bool found = false;
+	// Own queue first, newest job (still warm in cache).
+	{
+		Queue& own = *m_queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.entries.empty()) {
+			entry = std::move(own.entries.back());
+			own.entries.pop_back();
+			found = true;
+		}
+	}
+	// Else steal the oldest job from another queue.
+	for (size_t i = 1; !found && i < m_queues.size(); i++) {
+		Queue& other = *m_queues[(index + i) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(other.mutex);
+		if (!other.entries.empty()) {
+			entry = std::move(other.entries.front());
+			other.entries.pop_front();
+			found = true;
+		}
+	}
+	if (!found && background) {
+		std::lock_guard<std::mutex> lock(m_background.mutex);
+		if (!m_background.entries.empty()) {
+			entry = std::move(m_background.entries.front());
+			m_background.entries.pop_front();
+			found = true;
+		}
+	}
+	if (!found) {
+		return false;
+	}
+	m_queued--;
+	entry.job();
+	finish(entry.p_counter);
+	return true;
+}
+
+void df::JobManager::push(Entry entry) {
+	int index = t_queue_index >= 0 ? t_queue_index : getWorkerCount();
+	{
+		Queue& own = *m_queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		own.entries.push_back(std::move(entry));
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_queued++;
+	}
+	m_wake.notify_one();
+}
+
+void df::JobManager::finish(df::JobCounter* p_counter) {
+	if (!p_counter) {
+		return;
+	}
+	// The last decrement happens under the lock, and wait() takes the lock before returning,
+	// so the counter (often on the waiter's stack) outlives every use here.
+	std::vector<df::Job> ready;
+	{
+		std::lock_guard<std::mutex> lock(p_counter->m_mutex);
+		if (--p_counter->m_count > 0) {
+			return;
+		}
+		ready.swap(p_counter->m_waiting);
+	}
+	for (size_t i = 0; i < ready.size(); i++) {
+		ready[i]();
+	}
+}
+
+void df::JobManager::run(df::Job job, df::JobCounter* p_counter) {
+	if (p_counter) {
+		p_counter->m_count++;
+	}
+	if (!isStarted()) {
+		job();
+		finish(p_counter);
+		return;
+	}
+	Entry entry = { std::move(job), p_counter };
+	push(std::move(entry));
+}
+
+void df::JobManager::runBackground(df::Job job) {
+	if (!isStarted()) {
+		job();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_background.mutex);
+		Entry entry = { std::move(job), NULL };
+		m_background.entries.push_back(std::move(entry));
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_queued++;
+	}
+	m_wake.notify_one();
+}
+
+void df::JobManager::runAfter(df::JobCounter* p_dependency, df::Job job, df::JobCounter* p_counter) {
+	if (p_counter) {
+		p_counter->m_count++;
+	}
+	// Queued through the dependency's waiting list so it runs as soon as the dependency finishes.
+	df::Job queue_job = [this, job, p_counter]() {
+		if (!isStarted()) {
+			job();
+			finish(p_counter);
+			return;
+		}
+		Entry entry = { job, p_counter };
+		push(std::move(entry));
+	};
+	{
+		std::lock_guard<std::mutex> lock(p_dependency->m_mutex);
+		if (p_dependency->m_count.load() > 0) {
+			p_dependency->m_waiting.push_back(queue_job);
+			return;
+		}
+	}
+	queue_job();
+}
+
+void df::JobManager::wait(df::JobCounter* p_counter) {
+	int index = t_queue_index >= 0 ? t_queue_index : getWorkerCount();
+	while (!p_counter->isDone()) {
+		if (!isStarted() || !runOne(index, false)) {
+			std::this_thread::yield();
+		}
+	}
+	// Wait for the finishing thread to let go of the counter before the caller destroys it.
+	std::lock_guard<std::mutex> lock(p_counter->m_mutex);
+}
+
+void df::JobManager::parallelFor(int count, int grain, std::function<void(int begin, int end)> body) {
+	if (count <= 0) {
+		return;
+	}
+	if (grain < 1) {
+		grain = 1;
+	}
+	if (!isStarted() || count <= grain) {
+		body(0, count);
+		return;
+	}
+	df::JobCounter counter;
+	for (int begin = 0; begin < count; begin += grain) {
+		int end = begin + grain < count ? begin + grain : count;
+		run([&body, begin, end]() { body(begin, end); }, &counter);
+	}
+	wait(&counter);
+}
@@ -0,0 +1,123 @@
+/**
+	@file JobManager.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __JOB_MANAGER_H__
+#define __JOB_MANAGER_H__
+
+// System includes.
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Manager.h"
+
+// Two-letter acronym for easier access to manager.
+#define JM df::JobManager::getInstance()
+
+namespace df {
+
+	// Unit of work run by the JobManager.
+	typedef std::function<void()> Job;
+
+	// Number of jobs still to finish. Jobs can wait on it or be queued to run once it reaches 0.
+	class JobCounter {
+
+	private:
+		std::atomic<int> m_count;    // Jobs not finished yet.
+		std::mutex m_mutex;          // Guards m_waiting and the decrement to 0.
+		std::vector<Job> m_waiting;  // Jobs to queue when m_count reaches 0.
+		JobCounter(JobCounter const&);      // Don't allow copy.
+		void operator=(JobCounter const&);  // Don't allow assignment.
+		friend class JobManager;
+	public:
+		JobCounter();
+
+		// Return number of jobs not finished yet.
+		int getCount() const;
+
+		// Return true if all jobs are finished.
+		bool isDone() const;
+	};
+
+	class JobManager : public Manager {
+
+	private:
+		// Job in a queue, with the counter to decrement when done.
+		struct Entry {
+			Job job;
+			JobCounter* p_counter;
+		};
+
+		// Queue owned by one thread. The owner takes from the back, others steal from the front.
+		struct Queue {
+			std::deque<Entry> entries;
+			std::mutex mutex;
+		};
+
+		JobManager();                      // Private since a singleton.
+		JobManager(JobManager const&);     // Don't allow copy.
+		void operator=(JobManager const&); // Don't allow assignment.
+		std::vector<std::unique_ptr<Queue>> m_queues; // One per worker, then one for the main thread.
+		Queue m_background;                 // Long jobs only workers take (see runBackground()).
+		std::vector<std::thread> m_workers; // Worker threads.
+		std::atomic<int> m_queued;          // Jobs in all queues, including m_background.
+		std::atomic<bool> m_stopping;       // True while shutting down.
+		std::mutex m_sleep_mutex;           // Guards sleeping on m_wake.
+		std::condition_variable m_wake;     // Signalled when a job is queued or on shutdown.
+
+		// Worker loop for queue index.
+		void work(int index);
+
+		// Take a job from queue index (or steal one) and run it.
+		// If background, m_background is tried last.
+		// Return true if a job was run.
+		bool runOne(int index, bool background);
+
+		// Put job on the calling thread's queue.
+		void push(Entry entry);
+
+		// Job for counter is done. Queue its waiting jobs if it reached 0.
+		void finish(JobCounter* p_counter);
+	public:
+		// Get the one and only instance of the JobManager.
+		static JobManager& getInstance();
+
+		// Start one worker per hardware thread, less one for the main thread (at least 1).
+		// Return 0 if ok, else -1.
+		int startUp();
+
+		// Finish queued jobs and stop workers.
+		void shutDown();
+
+		// Return number of worker threads (not counting the main thread).
+		int getWorkerCount() const;
+
+		// Queue job. If p_counter, it is incremented now and decremented when job is done.
+		// Runs job right away if not started.
+		void run(Job job, JobCounter* p_counter = NULL);
+
+		// Queue long job (e.g., decoding a file) for a worker. wait() never runs it, so it
+		// can't stall a frame. Runs job right away if not started.
+		void runBackground(Job job);
+
+		// Queue job once p_dependency reaches 0. p_counter as for run().
+		void runAfter(JobCounter* p_dependency, Job job, JobCounter* p_counter = NULL);
+
+		// Run queued jobs (not background ones) on the calling thread until p_counter reaches 0.
+		void wait(JobCounter* p_counter);
+
+		// Call body(begin, end) over [0, count) in chunks of up to grain, spread across all threads.
+		// Return when every chunk is done.
+		void parallelFor(int count, int grain, std::function<void(int begin, int end)> body);
+	};
+
+} // end of namespace df
+#endif // __JOB_MANAGER_H__
@@ -97,6 +97,12 @@ int df::Manager::unregisterInterest(df::Object* p_o, std::string event_type) {
 	return 0;
 }
 
+void df::Manager::removeMarked() {
+	for (int i = 0; i < event_count; i++) {
+		obj_list[i].removeMarked();
+	}
+}
+
 int df::Manager::onEvent(const df::Event* p_event) const {
 	int count = 0;
 	for (int i = 0; i < event_count; i++) {
@@ -54,6 +54,9 @@ namespace df {
 		// Indicate no more interest in event.
 		// Return 0 if ok, else −1.
 		int unregisterInterest(Object* p_o, std::string event_type);
+		// Drop Objects marked for delete from all interest lists, one pass per list.
+		// Used by the WorldManager deletion phase instead of per-Object unregisterInterest().
+		void removeMarked();
 		// Send event to all interested Objects.
 		// Return count of number of events sent.
 		int onEvent(const Event* p_event) const;
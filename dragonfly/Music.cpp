@@ -32,6 +32,15 @@ int df::Music::loadMusic(std::string filename) {
 	return 0;
 }
 
+int df::Music::loadMusicFromMemory(const void* p_data, size_t size) {
+	if (!m_music.openFromMemory(p_data, size)) {
+		LM.writeLog("ERROR", "Music", "Error loading music '%s' from memory", m_label.c_str());
+		return -1;
+	}
+	setLoaded();
+	return 0;
+}
+
 void df::Music::setLabel(std::string new_label) {
 	m_label = new_label;
 }
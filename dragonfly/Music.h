@@ -28,6 +28,11 @@ namespace df {
 		// Return 0 if ok, else -1.
 		int loadMusic(std::string filename);
 
+		// Associate music with encoded file contents in memory.
+		// Music is streamed from that memory, so it must stay valid while the music is loaded.
+		// Return 0 if ok, else -1.
+		int loadMusicFromMemory(const void* p_data, size_t size);
+
 		// Set label associated with music.
 		void setLabel(std::string new_label);
 
@@ -8,7 +8,9 @@
 
 // Engine includes.
 #include "GameManager.h"
+#include "InputManager.h"
 #include "LogManager.h"
+#include "Prefab.h"
 #include "ResourceManager.h"
 #include "WorldManager.h"
 #include "DisplayManager.h"
@@ -20,37 +22,46 @@
 
 static int counter = 0;
 
+// Return true if event is sent by the InputManager.
+static bool isInputEvent(const std::string& event_type) {
+	return event_type == df::KEYBOARD_EVENT || event_type == df::MSE_EVENT;
+}
+
 df::Object::Object() {
 	m_id = counter;
 	counter++;
-	m_type = "Object";
-	df::Vector v;
-	m_position = v;
-	m_direction = v;
-	m_speed = 0;
-	sprite_name = "";
+	m_type_id = df::intern("Object");
+	m_slot = WM.getTransforms().allocate(this);
+	m_handle = WM.getHandles().issue(this);
 	m_altitude = 0;
 	m_solidness = df::Solidness::HARD;
 	m_no_soft = false;
+	m_collision_stay = true;
+	m_collision_end = false;
 	m_animation = df::Animation();
-	m_box = df::Box();
-	event_count = 0;
-	event_name;
 	is_active = true;
 	is_visible = true;
 	overlapHandle = df::OverlapHandle::ATTEMPT_TO_MOVE;
-	has_gravity = false;
 	m_view_object = false;
-	WM.registerInterest(this, df::STEP_EVENT);
-
-	writeLog("", "Spawned. Awaiting sprite or manual insert for world insertion.");
+	m_marked_for_delete = false;
+	m_contact_flags = 0;
+	m_ground = df::Handle();
+	if (!WM.addToSpawnBatch(this)) {
+		writeLog("", "Spawned. Awaiting sprite or manual insert for world insertion.");
+	}
 }
 
 df::Object::~Object() {
-	WM.removeObject(this);
-	for (int i = event_count - 1; i >= 0; i--) {
-		unregisterInterest(this, event_name[i]);
+	// The deletion phase has already swept marked Objects out of the world and interest lists.
+	if (!m_marked_for_delete) {
+		WM.removeObject(this);
+		while (!m_events.empty()) {
+			unregisterInterest(this, df::internedString(m_events.back()));
+		}
 	}
+	WM.getComponents().removeAll(this);
+	WM.getTransforms().release(m_slot);
+	WM.getHandles().release(m_handle);
 	writeLog("ALERT", "Die.");
 }
 
@@ -63,20 +74,29 @@ int df::Object::getId() const {
 }
 
 void df::Object::setType(std::string new_type) {
-	m_type = new_type;
+	df::StringId old_type_id = m_type_id;
+	m_type_id = df::intern(new_type);
+	WM.updateType(this, old_type_id);
 	writeLog("", "Renamed %s.", new_type.c_str());
 }
 
-std::string df::Object::getType() const {
-	return m_type;
+const std::string& df::Object::getType() const {
+	return df::internedString(m_type_id);
+}
+
+df::StringId df::Object::getTypeId() const {
+	return m_type_id;
 }
 
 void df::Object::setPosition(Vector new_position) {
-	m_position = new_position;
+	WM.getTransforms().setPosition(m_slot, new_position);
+	WM.updateLocation(this);
+	m_contact_flags = 0;
+	m_ground = df::Handle();
 }
 
 df::Vector df::Object::getPosition() const {
-	return m_position;
+	return WM.getTransforms().getPosition(m_slot);
 }
 
 int df::Object::eventHandler(const Event* p_event) {
@@ -88,11 +108,9 @@ bool df::Object::isSolid() const {
 }
 
 int df::Object::setSolidness(df::Solidness new_solid) {
-	if (WM.getSceneGraph().updateSolidness(this, new_solid)) {
-		return -1;
-	}
+	bool was_solid = isSolid();
 	m_solidness = new_solid;
-	return 0;
+	return WM.updateSolidness(this, was_solid);
 }
 
 df::Solidness df::Object::getSolidness() const {
@@ -100,11 +118,13 @@ df::Solidness df::Object::getSolidness() const {
 }
 
 int df::Object::setAltitude(int new_altitude) {
-	if (WM.getSceneGraph().updateAltitude(this, new_altitude)) {
+	if (!df::valueInRange(new_altitude, 0, df::MAX_ALTITUDE)) {
+		writeLog("ERROR", "Altitude %d not in range.", new_altitude);
 		return -1;
 	}
+	int old_altitude = m_altitude;
 	m_altitude = new_altitude;
-	return 0;
+	return WM.updateAltitude(this, old_altitude);
 }
 
 int df::Object::getAltitude() const {
@@ -112,43 +132,74 @@ int df::Object::getAltitude() const {
 }
 
 void df::Object::setSpeed(float new_speed) {
-	m_speed = new_speed;
+	setVelocity(getDirection() * new_speed);
 }
 
 float df::Object::getSpeed() const {
-	return m_speed;
+	return getVelocity().getMagnitude();
 }
 
 void df::Object::setDirection(Vector new_direction) {
-	m_direction = new_direction;
+	setVelocity(new_direction * getSpeed());
 }
 
 df::Vector df::Object::getDirection() const {
-	return m_direction;
+	df::Vector v = getVelocity();
+	v.normalize();
+	return v;
 }
 
 void df::Object::setVelocity(df::Vector new_velocity) {
-	m_speed = new_velocity.getMagnitude();
-	m_direction = new_velocity;
-	m_direction.normalize();
+	WM.getTransforms().setVelocity(m_slot, new_velocity);
+	// Left as a mover once at rest. The move system drops it then.
+	if (new_velocity.getX() != 0 || new_velocity.getY() != 0) {
+		WM.getComponents().add(this, df::Component::VELOCITY);
+		WM.getTransforms().setMoving(m_slot, true);
+	}
 }
 
 df::Vector df::Object::getVelocity() const {
-	df::Vector v(m_direction.getX() * m_speed, m_direction.getY() * m_speed);
-	return v;
+	return WM.getTransforms().getVelocity(m_slot);
 }
 
 void df::Object::hasGravity(bool new_has_gravity) {
-	has_gravity = new_has_gravity;
+	WM.getTransforms().setGravity(m_slot, new_has_gravity);
+	if (new_has_gravity) {
+		WM.getComponents().add(this, df::Component::GRAVITY);
+		WM.getComponents().add(this, df::Component::VELOCITY);
+		WM.getTransforms().setMoving(m_slot, true);
+	}
+	else {
+		WM.getComponents().remove(this, df::Component::GRAVITY);
+	}
 }
 
 bool df::Object::hasGravity() const {
-	return has_gravity;
+	return WM.getTransforms().hasGravity(m_slot);
+}
+
+void df::Object::setDamping(float new_damping) {
+	WM.getTransforms().setDamping(m_slot, new_damping);
+}
+
+float df::Object::getDamping() const {
+	return WM.getTransforms().getDamping(m_slot);
+}
+
+int df::Object::getSlot() const {
+	return m_slot;
+}
+
+df::Handle df::Object::getHandle() const {
+	return m_handle;
+}
+
+bool df::Object::isMarkedForDelete() const {
+	return m_marked_for_delete;
 }
 
 df::Vector df::Object::predictPosition() {
-	df::Vector v = m_position + getVelocity();
-	return (v);
+	return getPosition() + getVelocity();
 }
 
 void df::Object::setNoSoft(bool new_no_soft) {
@@ -159,17 +210,89 @@ bool df::Object::getNoSoft() const {
 	return m_no_soft;
 }
 
+void df::Object::setCollisionPhases(bool stay, bool end) {
+	m_collision_stay = stay;
+	m_collision_end = end;
+}
+
+bool df::Object::wantsCollisionPhase(df::CollisionPhase phase) const {
+	switch (phase) {
+	case df::CollisionPhase::STAY:
+		return m_collision_stay;
+	case df::CollisionPhase::END:
+		return m_collision_end;
+	default:
+		return true;
+	}
+}
+
 int df::Object::setSprite(std::string sprite_label) {
-	std::string old_string = sprite_name;
 	df::Sprite* p_sprite = RM.getSprite(sprite_label);
 	if (!p_sprite) {
 		writeLog("ERROR", "Error getting '%s' sprite.", sprite_label.c_str());
 		return -1;
 	}
+	return applySprite(p_sprite);
+}
+
+int df::Object::setSprite(df::SpriteHandle sprite_handle) {
+	df::Sprite* p_sprite = RM.getSprite(sprite_handle);
+	if (!p_sprite) {
+		writeLog("ERROR", "Error getting sprite from handle %d.", sprite_handle.getIndex());
+		return -1;
+	}
+	return applySprite(p_sprite);
+}
+
+int df::Object::applyPrefab(const df::Prefab* p_prefab) {
+	if (!p_prefab) {
+		writeLog("ERROR", "Error applying prefab. Prefab not loaded.");
+		return -1;
+	}
+	df::Box box = getBox();
+	if (p_prefab->sprite.isValid()) {
+		df::Sprite* p_sprite = RM.getSprite(p_prefab->sprite);
+		if (!p_sprite) {
+			writeLog("ERROR", "Error getting '%s' sprite for prefab '%s'.", p_prefab->sprite_label.c_str(), p_prefab->label.c_str());
+			return -1;
+		}
+		m_animation.setSprite(p_sprite);
+		box = m_animation.getBox();
+	}
+	box = df::Box(df::Vector(box.getCorner().getX() + p_prefab->box_left, box.getCorner().getY() + p_prefab->box_top),
+		box.getHorizontal() - p_prefab->box_left - p_prefab->box_right,
+		box.getVertical() - p_prefab->box_top - p_prefab->box_bottom);
+	// Fields are copied straight from the prefab. The WorldManager hears about the old values once each.
+	const df::StringId old_type_id = m_type_id;
+	const int old_altitude = m_altitude;
+	const bool was_solid = isSolid();
+	if (p_prefab->type != -1) {
+		m_type_id = p_prefab->type;
+	}
+	m_altitude = p_prefab->altitude;
+	m_solidness = p_prefab->solidness;
+	hasGravity(p_prefab->gravity);
+	WM.getTransforms().setDamping(m_slot, p_prefab->damping);
+	setBox(box);
+	updateAnimated();
+	WM.updateType(this, old_type_id);
+	WM.updateAltitude(this, old_altitude);
+	WM.updateSolidness(this, was_solid);
+	for (size_t i = 0; i < p_prefab->events.size(); i++) {
+		if (registerInterest(p_prefab->events[i]) == -1) {
+			writeLog("ERROR", "Error registering for '%s' from prefab '%s'.", p_prefab->events[i].c_str(), p_prefab->label.c_str());
+			return -1;
+		}
+	}
+	return WM.insertObject(this);
+}
+
+int df::Object::applySprite(df::Sprite* p_sprite) {
+	std::string sprite_label = p_sprite->getLabel();
 	df::Sprite* old_sprite = m_animation.getSprite();
 	m_animation.setSprite(p_sprite);
 	setBox(m_animation.getBox());
-	sprite_name = sprite_label;
+	updateAnimated();
 	// If there are collisions after changing the sprite.
 	/*if (WM.getCollisions(this).getCount() > 0) {
 		writeLog("ALERT", "Error setting sprite '%s'. Collision on change. Attempting to move.", sprite_label.c_str());
@@ -177,8 +300,7 @@ int df::Object::setSprite(std::string sprite_label) {
 			if (!tryToMove()) {
 				m_animation.setSprite(old_sprite);
 				setBox(m_animation.getBox());
-				sprite_name = old_string;
-				writeLog("ERROR", "No nearby locations found. Reverted to '%s'.", old_string.c_str());
+				writeLog("ERROR", "No nearby locations found. Reverted to '%s'.", old_sprite->getLabel().c_str());
 				return -1;
 			}
 		}
@@ -186,13 +308,14 @@ int df::Object::setSprite(std::string sprite_label) {
 			if (!tryToMove()) {
 				m_animation.clearSprite();
 				setBox(m_animation.getBox());
-				sprite_name = "";
 				writeLog("ERROR", "No nearby locations found. Cleared sprite.");
 				return -1;
 			}
 		}
 	}*/
-	writeLog("", "Sprite set to '%s'.", sprite_label.c_str());
+	if (!WM.isSpawning()) {
+		writeLog("", "Sprite set to '%s'.", sprite_label.c_str());
+	}
 	if (!old_sprite) {
 		return WM.insertObject(this);
 	}
@@ -201,6 +324,20 @@ int df::Object::setSprite(std::string sprite_label) {
 
 void df::Object::setAnimation(Animation new_animation) {
 	m_animation = new_animation;
+	updateAnimated();
+}
+
+void df::Object::updateAnimated() {
+	if (m_animation.getSprite() && m_animation.getSprite()->getFrameCount() > 1) {
+		WM.getComponents().add(this, df::Component::ANIMATED);
+	}
+	else {
+		WM.getComponents().remove(this, df::Component::ANIMATED);
+	}
+}
+
+bool df::Object::hasComponent(df::Component component) const {
+	return WM.getComponents().has(this, component);
 }
 
 df::Animation* df::Object::getAnimation() {
@@ -208,11 +345,16 @@ df::Animation* df::Object::getAnimation() {
 }
 
 void df::Object::setBox(df::Box new_box) {
-	m_box = new_box;
+	WM.getTransforms().setBox(m_slot, new_box);
+	WM.updateLocation(this);
 }
 
 df::Box df::Object::getBox() const {
-	return m_box;
+	return WM.getTransforms().getBox(m_slot);
+}
+
+df::Aabb df::Object::getWorldAabb() const {
+	return WM.getTransforms().getWorldBox(m_slot);
 }
 
 int df::Object::draw() {
@@ -240,11 +382,20 @@ int df::Object::draw() {
 }
 
 int df::Object::registerInterest(df::Object* p_o, std::string event_type) {
-	if (event_count == df::MAX_OBJ_EVENTS || GM.registerInterest(this, event_type) == -1) {
+	// Step events are sent by the WorldManager to its step listeners.
+	if (event_type == df::STEP_EVENT) {
+		WM.getComponents().add(this, df::Component::STEP_LISTENER);
+		return 0;
+	}
+	if ((int)m_events.size() == df::MAX_OBJ_EVENTS) {
+		return -1;
+	}
+	// Input events are sent by the InputManager, the rest by the GameManager.
+	df::Manager& manager = isInputEvent(event_type) ? (df::Manager&)IM : (df::Manager&)GM;
+	if (manager.registerInterest(this, event_type) == -1) {
 		return -1;
 	}
-	event_name[event_count] = event_type;
-	event_count++;
+	m_events.push_back(df::intern(event_type));
 	return 0;
 }
 
@@ -253,18 +404,23 @@ int df::Object::registerInterest(std::string event_type) {
 }
 
 int df::Object::unregisterInterest(df::Object* p_o, std::string event_type) {
-	for (int i = 0; i < event_count; i++) {
-		if (event_name[i] == event_type) {
-			if (event_type == df::STEP_EVENT) {
-				GM.unregisterInterest(this, event_type);
+	if (event_type == df::STEP_EVENT) {
+		if (!hasComponent(df::Component::STEP_LISTENER)) {
+			return -1;
+		}
+		WM.getComponents().remove(this, df::Component::STEP_LISTENER);
+		return 0;
+	}
+	const df::StringId event_id = df::intern(event_type);
+	for (size_t i = 0; i < m_events.size(); i++) {
+		if (m_events[i] == event_id) {
+			if (isInputEvent(event_type)) {
+				IM.unregisterInterest(this, event_type);
 			}
 			else {
-				WM.unregisterInterest(this, event_type);
-			}
-			for (int j = i; j < event_count - 1; j++) {
-				event_name[j] = event_name[j + 1];
+				GM.unregisterInterest(this, event_type);
 			}
-			event_count--;
+			m_events.erase(m_events.begin() + i);
 			return 0;
 		}
 	}
@@ -280,11 +436,9 @@ int df::Object::writeLog(std::string warn, const char* fmt, ...) const {
 }
 
 int df::Object::setActive(bool active) {
-	if (WM.getSceneGraph().updateActive(this, active)) {
-		return -1;
-	}
+	bool was_active = is_active;
 	is_active = active;
-	return 0;
+	return WM.updateActive(this, was_active);
 }
 
 bool df::Object::isActive() const {
@@ -292,11 +446,9 @@ bool df::Object::isActive() const {
 }
 
 int df::Object::setVisible(bool visible) {
-	if (WM.getSceneGraph().updateVisible(this, visible)) {
-		return -1;
-	}
+	bool was_visible = is_visible;
 	is_visible = visible;
-	return 0;
+	return WM.updateVisible(this, was_visible);
 }
 
 bool df::Object::isVisible() const {
@@ -324,23 +476,40 @@ bool df::Object::tryToMove() {
 	return true;
 }
 
-bool df::Object::isGrounded() {
-	// probably on the ground if we would collide with something if we moved slightly downwards
+int df::Object::getContacts() const {
+	return m_contact_flags;
+}
 
-	auto obj = WM.getCollisions(this, getPosition() + df::Vector(0, 0.05f));
-	df::ObjectListIterator li(&obj);
-	li.first();
-	while(!li.isDone()) {
-		if(li.currentObject()->getSolidness() == df::Solidness::HARD) return true;
-		li.next();
-	}
-	return false;
+df::Handle df::Object::getGround() const {
+	return m_ground;
+}
+
+bool df::Object::isGrounded() const {
+	// Gravity pulls grounded Objects down every step, so a blocked move down means standing on something.
+	return (m_contact_flags & df::CONTACT_GROUND) != 0;
 }
 
 void df::Object::setIsViewObject(bool new_is_view_object) {
 	m_view_object = new_is_view_object;
 }
 
-bool df::Object::isViewObject() {
+bool df::Object::isViewObject() const {
 	return m_view_object;
 }
+
+void df::Object::setParallelStep(bool new_parallel_step) {
+	if (new_parallel_step) {
+		WM.getComponents().add(this, df::Component::AI);
+	}
+	else {
+		WM.getComponents().remove(this, df::Component::AI);
+	}
+}
+
+bool df::Object::getParallelStep() const {
+	return hasComponent(df::Component::AI);
+}
+
+void df::Object::stepParallel(int /*step_count*/) {
+
+}
@@ -8,12 +8,20 @@
 #define __OBJECT_H__
 
 // Engine includes.
+#include "Aabb.h"
 #include "Animation.h"
 #include "Box.h"
+#include "ComponentRegistry.h"
 #include "Event.h"
+#include "Handle.h"
+#include "Intern.h"
+#include "ResourceHandle.h"
 #include "Sprite.h"
 #include "Vector.h"
 
+// System includes.
+#include <vector>
+
 namespace df {
 
 	const int MAX_OBJ_EVENTS = 100;
@@ -24,6 +32,12 @@ namespace df {
 		SOFT,       // Object causes collision, but doesn't impede.
 		SPECTRAL,   // Object doesn't cause collisions.
 	};
+	// Phases of a contact between two Objects (see EventCollision).
+	enum class CollisionPhase {
+		BEGIN, // First step the Objects touch.
+		STAY,  // Each later step they still touch.
+		END,   // First step they no longer touch.
+	};
 	// Ways to handle overlap on spawn.
 	enum class OverlapHandle {
 		DO_NOT_SPAWN, // Do not spawn impeded object
@@ -31,27 +45,47 @@ namespace df {
 		SPAWN_ALWAYS // Spawn anyways. You shouldn't use this.
 	};
 
+	// Sides on which an Object was blocked in its last move (bit flags, see Object::getContacts()).
+	const int CONTACT_GROUND = 0x1;     // Moving down.
+	const int CONTACT_CEILING = 0x2;    // Moving up.
+	const int CONTACT_WALL_LEFT = 0x4;  // Moving left.
+	const int CONTACT_WALL_RIGHT = 0x8; // Moving right.
+
+	struct Prefab;
+
 	class Object {
 
 	private:
+		// Read every step. Position, velocity and box are in WorldManager's TransformStore.
+		int m_slot; // Slot in WorldManager's TransformStore (position, velocity, box, gravity).
 		int m_id; // Unique game engine defined identifier.
-		std::string m_type; // Game-programmer defined identification.
-		Box m_box; // Box for sprite boundary & collisions.
-		Vector m_position; // Position in game world.
-		Vector m_direction; // Direction vector.
-		float m_speed; // Object speed in direction.
-		std::string sprite_name; // Sprite name in ResourceManager.
-		Animation m_animation; // Animation associated with Object.
+		Handle m_handle; // Handle other code can hold to this Object.
+		StringId m_type_id; // Game-programmer defined identification (interned, see getType()).
 		int m_altitude; // 0 to MAX_ALTITUDE (higher drawn on top).
 		Solidness m_solidness; // Solidness state of Object.
-		bool m_no_soft; // Treat collisions with SOFT objects the same as HARD objects if true
-		int event_count; // The number of events that can be received by this object.
-		std::string event_name[MAX_OBJ_EVENTS]; // The events that can be received by this object.
 		bool is_active; // Don't update if not active
 		bool is_visible; // Don't draw if not visible
-		OverlapHandle overlapHandle; // How to treat this object on spawn
-		bool has_gravity; // Is affected by gravity
+		bool m_no_soft; // Treat collisions with SOFT objects the same as HARD objects if true
+		bool m_collision_stay; // Sent collision stay events
+		bool m_collision_end; // Sent collision end events
 		bool m_view_object;
+		bool m_marked_for_delete; // Waiting for the WorldManager deletion phase
+		int m_contact_flags; // CONTACT_ sides blocked in last move (set by WorldManager::moveObject())
+		Handle m_ground; // Object blocking last move down (null handle if none)
+		OverlapHandle overlapHandle; // How to treat this object on spawn
+
+		// Rarely touched.
+		std::vector<StringId> m_events; // Interned events this object is registered for (at most MAX_OBJ_EVENTS).
+		Animation m_animation; // Animation associated with Object (sprite name is the Sprite's label).
+
+		// Set Sprite to an already resolved one. Shared by both setSprite() overloads.
+		int applySprite(Sprite* p_sprite);
+
+		// Give or take ANIMATED component to match the current Sprite.
+		void updateAnimated();
+
+		friend class TransformStore; // Moves Objects between slots.
+		friend class WorldManager;   // Marks Objects for delete and records contacts.
 	protected:
 		// Writes to log with the object type and id being the reporter
 		int writeLog(std::string warn, const char* fmt, ...) const;
@@ -73,9 +107,13 @@ namespace df {
 		void setType(std::string new_type);
 
 		// Get type identifier of Object.
-		std::string getType() const;
+		const std::string& getType() const;
+
+		// Get interned type identifier of Object (compare against df::intern("Type")).
+		StringId getTypeId() const;
 
 		// Set position of Object.
+		// Clears contacts, as the Object may no longer be touching what it was.
 		virtual void setPosition(Vector new_position);
 
 		// Get position of Object.
@@ -103,25 +141,26 @@ namespace df {
 		// Return altitude of Object.
 		int getAltitude() const;
 
-		// Set speed of Object.
+		// Set speed of Object, keeping direction.
+		// Velocity is what is stored, so direction is lost while speed is 0.
 		void setSpeed(float new_speed);
 
 		// Get speed of Object.
 		float getSpeed() const;
 
-		// Set direction of Object.
+		// Set direction of Object, keeping speed.
 		void setDirection(Vector new_direction);
 
-		// Get direction of Object.
+		// Get direction of Object (unit vector, or zero if not moving).
 		Vector getDirection() const;
 
-		// Set direction and speed of Object.
+		// Set velocity of Object.
 		void setVelocity(Vector new_velocity);
 
-		// Get velocity of Object based on direction and speed.
+		// Get velocity of Object.
 		Vector getVelocity() const;
 
-		// Predict Object position based on speed and direction.
+		// Predict Object position based on velocity.
 		// Return predicted position.
 		Vector predictPosition();
 
@@ -131,17 +170,52 @@ namespace df {
 		// Get if Object has gravity
 		bool hasGravity() const;
 
+		// Set fraction of velocity kept each step (1 for no damping, the default).
+		void setDamping(float new_damping);
+
+		// Get fraction of velocity kept each step.
+		float getDamping() const;
+
+		// Get slot of Object in WorldManager's TransformStore.
+		int getSlot() const;
+
+		// Get handle to Object. Unlike a pointer, safe to keep after the Object is deleted.
+		// Resolve with WorldManager::getObject().
+		Handle getHandle() const;
+
+		// Return true if WorldManager::markForDelete() was called on Object.
+		bool isMarkedForDelete() const;
+
 		// Set bounding box of Object.
 		void setBox(Box new_box);
 
 		// Get bounding box of Object.
 		Box getBox() const;
 
+		// Get bounding box at position, in world space.
+		// Cached, so cheaper than getWorldBox(): only setPosition() and setBox() change it.
+		Aabb getWorldAabb() const;
+
 		// Set Sprite for this Object to animate.
 		// It is imperetive that you call this as the last modifier of the class constructor as this class also adds the object to the screen.
 		// Return 0 if ok, else -1.
 		int setSprite(std::string sprite_label);
 
+		// Return true if Object has component (see ComponentRegistry.h).
+		// Components follow Object state: gravity, velocity, Sprite, step interest and parallel step.
+		bool hasComponent(Component component) const;
+
+		// Set Sprite for this Object to animate from a handle resolved with RM.getSpriteHandle().
+		// Same rules as setSprite(label), without the label lookup.
+		// Return 0 if ok, else -1.
+		int setSprite(SpriteHandle sprite_handle);
+
+		// Set up Object from prefab in one step (type, sprite, box, solidness, gravity, damping,
+		// altitude and events), then add it to the world. See Prefab.h.
+		// Call once from the constructor, in place of setSprite().
+		// Return 0 if ok, else -1.
+		int applyPrefab(const Prefab* p_prefab);
+
 		// Set Animation for this Object to new one.
 		// Set bounding box to size of associated Sprite.
 		void setAnimation(Animation new_animation);
@@ -157,7 +231,15 @@ namespace df {
 
 		bool getNoSoft() const;
 
+		// Choose which collision phases Object is sent (see EventCollision::getPhase()).
+		// Begin is always sent. Stay is sent every step while touching (default on), end once contact stops (default off).
+		void setCollisionPhases(bool stay, bool end);
+
+		// Return true if Object is sent collision events of phase.
+		bool wantsCollisionPhase(CollisionPhase phase) const;
+
 		// Indicate interest in event.
+		// Objects only get step events if they register for them.
 		// Return 0 if ok, else −1.
 		// (Note, doesn’t check to see if Object is already registered.)
 		int registerInterest(Object* p_o, std::string event_type);
@@ -188,11 +270,30 @@ namespace df {
 		// Try to move object so it isn't colliding
 		bool tryToMove();
 
-		bool isGrounded();
+		// Return CONTACT_ flags for the sides on which Object was blocked in its last move.
+		// Recorded by WorldManager::moveObject() as it resolves the move, so reading them is free.
+		int getContacts() const;
+
+		// Return handle of Object last move down was blocked by, else null handle.
+		Handle getGround() const;
+
+		// Return true if last move down was blocked (standing on something).
+		bool isGrounded() const;
 
 		void setIsViewObject(bool new_is_view_object = true);
 
-		bool isViewObject();
+		bool isViewObject() const;
+
+		// Set true to have stepParallel() called every step, before the step event.
+		void setParallelStep(bool new_parallel_step = true);
+
+		// Return true if stepParallel() is called every step.
+		bool getParallelStep() const;
+
+		// Parallel part of the step, run on a worker thread alongside other Objects'.
+		// May read the world but only write this Object's own fields. Anything else
+		// (spawning, deleting, touching other Objects) goes through WM.defer().
+		virtual void stepParallel(int step_count);
 	};
 } // end of namespace df
 #endif // __OBJECT_H__
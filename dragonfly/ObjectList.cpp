@@ -68,6 +68,35 @@ int df::ObjectList::insert(df::Object* p_o) {
 	return 0;
 }
 
+int df::ObjectList::append(df::Object* p_o) {
+	if (!p_o) {
+		return -1;
+	}
+	if (isFull()) {
+		if (!scale(2)) {
+			LM.writeLog("ERROR", "ObjectList", "Insert failed due to scale error.");
+			return -1;
+		}
+	}
+	m_p_obj[m_count] = p_o;
+	m_count++;
+	return 0;
+}
+
+bool df::ObjectList::reserve(int count) {
+	if (count <= max_count) {
+		return true;
+	}
+	df::Object** tmp_obj = (df::Object**)(realloc(m_p_obj, count * sizeof(df::Object*)));
+	if (tmp_obj == NULL) {
+		LM.writeLog("", "ObjectList", "Reserve failed.");
+		return false;
+	}
+	m_p_obj = tmp_obj;
+	max_count = count;
+	return true;
+}
+
 int df::ObjectList::remove(df::Object* p_o) {
 	for (int i = 0; i < m_count; i++) {
 		if (m_p_obj[i] == p_o) {
@@ -81,6 +110,19 @@ int df::ObjectList::remove(df::Object* p_o) {
 	return -1;
 }
 
+int df::ObjectList::removeMarked() {
+	int kept = 0;
+	for (int i = 0; i < m_count; i++) {
+		if (!m_p_obj[i]->isMarkedForDelete()) {
+			m_p_obj[kept] = m_p_obj[i];
+			kept++;
+		}
+	}
+	int removed = m_count - kept;
+	m_count = kept;
+	return removed;
+}
+
 bool df::ObjectList::clear() {
 	df::Object** tmp_obj = (df::Object**)(realloc(m_p_obj, sizeof(df::Object*)));
 	if (tmp_obj == NULL) {
@@ -38,9 +38,19 @@ namespace df {
 		// Insert object pointer in list.
 		// Return 0 if ok, else -1.
 		int insert(Object* p_o);
+		// Insert object pointer in list without checking for duplicates.
+		// Only for Objects known not to be in the list (e.g., freshly spawned).
+		// Return 0 if ok, else -1.
+		int append(Object* p_o);
+		// Make room for at least count objects in total, so appending up to count does not scale.
+		// Return true if successful, false otherwise.
+		bool reserve(int count);
 		// Remove object pointer from list,
 		// Return 0 if found, else -1.
 		int remove(Object* p_o);
+		// Remove all Objects marked for delete (see Object::isMarkedForDelete()), keeping order.
+		// One pass over the list. Return number removed.
+		int removeMarked();
 		// Clear list (setting count to 0).
 		bool clear();
 		// Return count of number of objects in list.
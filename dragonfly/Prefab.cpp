@@ -0,0 +1,118 @@
+/**
+	Prefab definitions and their text format.
+	@file Prefab.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "Prefab.h"
+
+// Engine includes.
+#include "SceneGraph.h"
+#include "utility.h"
+
+// System includes.
+#include <sstream>
+
+df::Prefab::Prefab() {
+	type = -1;
+	box_left = 0;
+	box_top = 0;
+	box_right = 0;
+	box_bottom = 0;
+	solidness = df::Solidness::HARD;
+	gravity = false;
+	damping = 1;
+	altitude = 0;
+}
+
+int df::parsePrefabs(const char* p_data, size_t size, std::vector<df::Prefab>* p_prefabs, std::string* p_error) {
+	std::istringstream text(std::string(p_data, size));
+	std::string line;
+	int line_number = 0;
+	df::Prefab* p_prefab = NULL; // Prefab being defined, NULL between blocks.
+	while (std::getline(text, line)) {
+		line_number++;
+		df::discardCR(line);
+		std::istringstream words(line);
+		std::string key;
+		if (!(words >> key) || key[0] == '#') {
+			continue; // Blank or comment.
+		}
+		const std::string where = "line " + std::to_string(line_number) + ": ";
+		if (key == "<" PREFAB_TOKEN) {
+			std::string label;
+			if (p_prefab || !(words >> label) || label.size() < 2 || label[label.size() - 1] != '>') {
+				*p_error = where + "expected <" PREFAB_TOKEN " label> outside a prefab.";
+				return -1;
+			}
+			p_prefabs->push_back(df::Prefab());
+			p_prefab = &p_prefabs->back();
+			p_prefab->label = label.substr(0, label.size() - 1);
+			continue;
+		}
+		if (!p_prefab) {
+			*p_error = where + "'" + key + "' outside a prefab.";
+			return -1;
+		}
+		bool ok = true;
+		if (key == "</" PREFAB_TOKEN ">") {
+			p_prefab = NULL;
+		}
+		else if (key == PREFAB_TYPE_TOKEN) {
+			std::string type;
+			ok = (bool)(words >> type);
+			p_prefab->type = ok ? df::intern(type) : -1;
+		}
+		else if (key == PREFAB_SPRITE_TOKEN) {
+			ok = (bool)(words >> p_prefab->sprite_label);
+		}
+		else if (key == PREFAB_BOX_TOKEN) {
+			ok = (bool)(words >> p_prefab->box_left >> p_prefab->box_top >> p_prefab->box_right >> p_prefab->box_bottom);
+		}
+		else if (key == PREFAB_SOLIDNESS_TOKEN) {
+			std::string solidness;
+			words >> solidness;
+			if (solidness == "hard") {
+				p_prefab->solidness = df::Solidness::HARD;
+			}
+			else if (solidness == "soft") {
+				p_prefab->solidness = df::Solidness::SOFT;
+			}
+			else if (solidness == "spectral") {
+				p_prefab->solidness = df::Solidness::SPECTRAL;
+			}
+			else {
+				ok = false;
+			}
+		}
+		else if (key == PREFAB_GRAVITY_TOKEN) {
+			int gravity = 0;
+			ok = (bool)(words >> gravity);
+			p_prefab->gravity = gravity != 0;
+		}
+		else if (key == PREFAB_DAMPING_TOKEN) {
+			ok = (bool)(words >> p_prefab->damping);
+		}
+		else if (key == PREFAB_ALTITUDE_TOKEN) {
+			ok = (bool)(words >> p_prefab->altitude) && df::valueInRange(p_prefab->altitude, 0, df::MAX_ALTITUDE);
+		}
+		else if (key == PREFAB_EVENT_TOKEN) {
+			std::string event_type;
+			ok = (bool)(words >> event_type);
+			p_prefab->events.push_back(event_type);
+		}
+		else {
+			*p_error = where + "unknown key '" + key + "'.";
+			return -1;
+		}
+		if (!ok) {
+			*p_error = where + "bad value for '" + key + "' in prefab '" + p_prefab->label + "'.";
+			return -1;
+		}
+	}
+	if (p_prefab) {
+		*p_error = "prefab '" + p_prefab->label + "' not closed.";
+		return -1;
+	}
+	return 0;
+}
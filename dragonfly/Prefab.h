@@ -0,0 +1,68 @@
+/**
+	@file Prefab.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __PREFAB_H__
+#define __PREFAB_H__
+
+// System includes.
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Engine includes.
+#include "Intern.h"
+#include "Object.h"
+#include "ResourceHandle.h"
+
+// Delimiters used to parse prefab files
+#define PREFAB_TOKEN "PREFAB"
+#define PREFAB_TYPE_TOKEN "type"
+#define PREFAB_SPRITE_TOKEN "sprite"
+#define PREFAB_BOX_TOKEN "box"
+#define PREFAB_SOLIDNESS_TOKEN "solidness"
+#define PREFAB_GRAVITY_TOKEN "gravity"
+#define PREFAB_DAMPING_TOKEN "damping"
+#define PREFAB_ALTITUDE_TOKEN "altitude"
+#define PREFAB_EVENT_TOKEN "event"
+
+namespace df {
+
+	// Archetype Objects are set up from in one step (see Object::applyPrefab()).
+	// Loaded from data by ResourceManager::loadPrefabs(), with type and sprite resolved up front,
+	// so applying a prefab does no string lookups.
+	struct Prefab {
+		std::string label;          // Name the prefab is looked up by.
+		StringId type;              // Interned Object type (-1 to leave unchanged).
+		std::string sprite_label;   // Sprite to animate ("" if none).
+		SpriteHandle sprite;        // Handle for sprite_label. Set on load.
+		float box_left, box_top;    // Box inset from the Sprite's edges (negative grows it).
+		float box_right, box_bottom;
+		Solidness solidness;
+		bool gravity;
+		float damping;              // Fraction of velocity kept each step.
+		int altitude;
+		std::vector<std::string> events; // Events to register interest in.
+
+		Prefab();
+	};
+
+	// Parse prefab file contents in one pass. Each prefab is a block:
+	//	<PREFAB label>
+	//	type Slime
+	//	sprite slime
+	//	box 0.5 1.25 0.5 0     (left top right bottom inset)
+	//	solidness hard         (hard, soft or spectral)
+	//	gravity 1
+	//	damping 1
+	//	altitude 0
+	//	event df::step         (one line per event)
+	//	</PREFAB>
+	// Keys may be left out for Object defaults. Lines starting with '#' are comments.
+	// Return 0 if ok, else -1 with reason in p_error.
+	int parsePrefabs(const char* p_data, size_t size, std::vector<Prefab>* p_prefabs, std::string* p_error);
+
+} // end of namespace df
+#endif // __PREFAB_H__
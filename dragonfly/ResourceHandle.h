@@ -0,0 +1,45 @@
+/**
+	@file ResourceHandle.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __RESOURCE_HANDLE_H__
+#define __RESOURCE_HANDLE_H__
+
+namespace df {
+
+	class Sprite;
+	class Sound;
+	class Music;
+
+	// Handle to a resource slot in the ResourceManager.
+	// Resolve once by label, then look up by index.
+	// Typed so a handle for one kind of resource can't be used to look up another.
+	template <typename T>
+	class ResourceHandle {
+	private:
+		int m_index; // Slot index in ResourceManager (-1 if invalid).
+	public:
+		// Create invalid handle.
+		ResourceHandle() : m_index(-1) {}
+
+		// Create handle to slot index.
+		explicit ResourceHandle(int index) : m_index(index) {}
+
+		// Return slot index.
+		int getIndex() const { return m_index; }
+
+		// Return true if handle refers to a slot.
+		bool isValid() const { return m_index >= 0; }
+
+		bool operator==(const ResourceHandle& other) const { return m_index == other.m_index; }
+		bool operator!=(const ResourceHandle& other) const { return m_index != other.m_index; }
+	};
+
+	typedef ResourceHandle<Sprite> SpriteHandle;
+	typedef ResourceHandle<Sound> SoundHandle;
+	typedef ResourceHandle<Music> MusicHandle;
+
+} // end of namespace df
+#endif // __RESOURCE_HANDLE_H__
@@ -7,16 +7,36 @@
 #include "ResourceManager.h"
 
 // Engine includes.
+#include "JobManager.h"
 #include "LogManager.h"
 #include "utility.h"
 
 // System includes.
+#include <chrono>
 #include <iostream>
 #include <fstream>
 
+df::LoadRequest::LoadRequest(df::ResourceType new_type, std::string new_filename, std::string new_label, std::function<void(int)> new_on_done) {
+	type = new_type;
+	filename = new_filename;
+	label = new_label;
+	on_done = new_on_done;
+}
+
+df::ResourceManager::DecodedResource::DecodedResource() {
+	p_sprite = NULL;
+	channel_count = 0;
+	sample_rate = 0;
+}
+
+df::ResourceManager::PendingLoad::PendingLoad(const df::LoadRequest& new_request) : request(new_request) {
+}
+
 df::ResourceManager::ResourceManager() {
 	setType("ResourceManager");
-	p_sprite[0] = NULL;
+	for (int i = 0; i < MAX_SPRITES; i++) {
+		p_sprite[i] = NULL;
+	}
 	m_sprite_count = 0;
 	m_sound;
 	m_sound_count = 0;
@@ -26,7 +46,9 @@ df::ResourceManager::ResourceManager() {
 
 df::ResourceManager::ResourceManager(ResourceManager const&) {
 	setType("ResourceManager");
-	p_sprite[0] = NULL;
+	for (int i = 0; i < MAX_SPRITES; i++) {
+		p_sprite[i] = NULL;
+	}
 	m_sprite_count = 0;
 	m_sound;
 	m_sound_count = 0;
@@ -55,318 +77,499 @@ int df::ResourceManager::startUp() {
 }
 
 void df::ResourceManager::shutDown() {
+	finishLoading();
 	for (int i = 0; i < m_sprite_count; i++) {
-		unloadSprite(p_sprite[i]->getLabel());
+		if (p_sprite[i]) {
+			unloadSprite(p_sprite[i]->getLabel());
+		}
 	}
 	for (int i = 0; i < m_sound_count; i++) {
-		unloadSound(m_sound[i].getLabel());
+		if (m_sound[i].getLoaded()) {
+			unloadSound(m_sound[i].getLabel());
+		}
 	}
 	for (int i = 0; i < m_music_count; i++) {
-		unloadMusic(m_music[i].getLabel());
+		if (m_music[i].getLoaded()) {
+			unloadMusic(m_music[i].getLabel());
+		}
 	}
+	m_sprite_index.clear();
+	m_sound_index.clear();
+	m_music_index.clear();
+	m_prefabs.clear();
+	m_prefab_index.clear();
+	m_sprite_count = 0;
+	m_sound_count = 0;
+	m_music_count = 0;
+	closePack();
 	df::Manager::shutDown();
 }
 
-int df::ResourceManager::loadSprite(std::string filename, std::string label) {
-	writeLog("", "Loading sprite '%s'.", label.c_str());
-	if (m_sprite_count >= MAX_SPRITES) {
-		writeLog("ERROR", "Unable to load sprite '%s'. Sprite array full.", label.c_str());
-		return -1;
+int df::ResourceManager::reserveSlot(std::unordered_map<std::string, int>* p_index, int* p_count, int max_count, const std::string& label) {
+	auto it = p_index->find(label);
+	if (it != p_index->end()) {
+		return it->second;
 	}
-	for (int i = 0; i < m_sprite_count; i++) {
-		if (label == p_sprite[i]->getLabel()) {
-			writeLog("ERROR", "Cannot load sprite with label '%s'. '%s' already loaded.", label.c_str(), label.c_str());
-			return -1;
-		}
-	}
-	writeLog("", "Loading file '%s'.", filename.c_str());
-	std::ifstream file(filename.c_str());
-	if (!file.good()) {
-		writeLog("ERROR", "Error opening '%s' sprite from file '%s'.", label.c_str(), filename.c_str());
-		writeLog("ALERT", "Sprite '%s' not loaded.", label.c_str());
-		file.close();
+	if (*p_count >= max_count) {
 		return -1;
 	}
-	std::vector<std::string> data = readData(&file, HEADER_TOKEN);
-	int x = matchLineInt(&data, "frames");
-	if (x == -1) {
-		writeLog("ERROR", "Error loading %s sprite: %s not declared in %s", label.c_str(), "frames", HEADER_TOKEN);
-		writeLog("ALERT", "Sprite '%s' not loaded.", label.c_str());
-		file.close();
-		return -1;
-	}
-	df::Sprite* sprite = new df::Sprite(x);
-	x = matchLineInt(&data, "width");
-	if (x == -1) {
-		writeLog("ERROR", "Error loading %s sprite: %s not declared in %s", label.c_str(), "width", HEADER_TOKEN);
-		writeLog("ALERT", "Sprite '%s' not loaded.", label.c_str());
-		delete sprite;
-		file.close();
-		return -1;
-	}
-	sprite->setWidth(x);
-	x = matchLineInt(&data, "height");
-	if (x == -1) {
-		writeLog("ERROR", "Error loading %s sprite: %s not declared in %s", label.c_str(), "height", HEADER_TOKEN);
-		writeLog("ALERT", "Sprite '%s' not loaded.", label.c_str());
-		delete sprite;
-		file.close();
+	int slot = *p_count;
+	(*p_index)[label] = slot;
+	(*p_count)++;
+	return slot;
+}
+
+int df::ResourceManager::openPack(std::string filename) {
+	writeLog("", "Opening asset pack '%s'.", filename.c_str());
+	std::string error;
+	if (m_pack.open(filename, &error) == -1) {
+		writeLog("ALERT", "Unable to open asset pack '%s': %s Loading from files.", filename.c_str(), error.c_str());
 		return -1;
 	}
-	sprite->setHeight(x);
-	std::string y = matchLineStr(&data, "color");
-	if (y != "") {
-		if (y == "black") {
-			sprite->setColor(df::Color::BLACK);
-		}
-		else if (y == "red") {
-			sprite->setColor(df::Color::RED);
-		}
-		else if (y == "green") {
-			sprite->setColor(df::Color::GREEN);
-		}
-		else if (y == "yellow") {
-			sprite->setColor(df::Color::YELLOW);
-		}
-		else if (y == "blue") {
-			sprite->setColor(df::Color::BLUE);
+	writeLog("", "Asset pack '%s' opened with %d assets.", filename.c_str(), m_pack.getCount());
+	return 0;
+}
+
+void df::ResourceManager::closePack() {
+	finishLoading(); // Workers may be reading from the pack.
+	m_pack.close();
+}
+
+std::vector<std::shared_future<int>> df::ResourceManager::loadBatch(const std::vector<df::LoadRequest>& requests) {
+	std::vector<std::shared_future<int>> results;
+	results.reserve(requests.size());
+	for (size_t i = 0; i < requests.size(); i++) {
+		const df::LoadRequest& request = requests[i];
+		int slot = -1;
+		if (request.type == df::ResourceType::SPRITE) {
+			slot = reserveSlot(&m_sprite_index, &m_sprite_count, MAX_SPRITES, request.label);
 		}
-		else if (y == "magenta") {
-			sprite->setColor(df::Color::MAGENTA);
+		else if (request.type == df::ResourceType::SOUND) {
+			slot = reserveSlot(&m_sound_index, &m_sound_count, MAX_SOUNDS, request.label);
 		}
-		else if (y == "cyan") {
-			sprite->setColor(df::Color::CYAN);
+		else {
+			slot = reserveSlot(&m_music_index, &m_music_count, MAX_MUSICS, request.label);
 		}
-		else if (y == "white") {
-			sprite->setColor(df::Color::WHITE);
-		} else if(y == "orange") {
-			sprite->setColor(df::Color::ORANGE);
+		df::ResourceManager::PendingLoad pending(request);
+		results.push_back(pending.done.get_future().share());
+		if (slot == -1) {
+			writeLog("ERROR", "Unable to load '%s'. Resource array full.", request.label.c_str());
+			pending.done.set_value(-1);
+			if (request.on_done) {
+				request.on_done(-1);
+			}
+			continue;
 		}
-		else if (y == "custom") {
-			sprite->setColor(df::Color::CUSTOM);
+		// Decoded on the JobManager's workers, so loading shares the game's threads rather than adding its own.
+		// Background jobs, so a decode never stalls the step's parallelFor().
+		std::shared_ptr<std::packaged_task<DecodedResource()>> p_task = std::make_shared<std::packaged_task<DecodedResource()>>([this, request]() { return decode(request); });
+		pending.decoded = p_task->get_future();
+		JM.runBackground([p_task]() { (*p_task)(); });
+		m_pending.push_back(std::move(pending));
+	}
+	writeLog("", "Loading %d resources in background.", (int)m_pending.size());
+	return results;
+}
+
+void df::ResourceManager::update() {
+	size_t i = 0;
+	while (i < m_pending.size()) {
+		if (m_pending[i].decoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			i++;
+			continue;
 		}
-		else {
-			sprite->setColor(df::COLOR_DEFAULT);
+		df::ResourceManager::PendingLoad pending = std::move(m_pending[i]);
+		m_pending.erase(m_pending.begin() + i);
+		df::ResourceManager::DecodedResource decoded = pending.decoded.get();
+		int result = registerDecoded(pending.request, &decoded);
+		pending.done.set_value(result);
+		if (pending.request.on_done) {
+			pending.request.on_done(result);
 		}
 	}
-	y = matchLineStr(&data, "transparent");
-	if (y.length() > 0) {
-		sprite->setTransparent(y[0]);
+}
+
+int df::ResourceManager::getPendingCount() const {
+	return (int)m_pending.size();
+}
+
+void df::ResourceManager::finishLoading() {
+	while (!m_pending.empty()) {
+		m_pending.front().decoded.wait();
+		update();
 	}
-	x = matchLineInt(&data, "slowdown");
-	if (x != -1) {
-		sprite->setSlowdown(x);
+}
+
+df::ResourceManager::DecodedResource df::ResourceManager::decode(const df::LoadRequest& request) const {
+	df::ResourceManager::DecodedResource decoded;
+	if (request.type == df::ResourceType::SPRITE) {
+		decoded.p_sprite = readSprite(request.filename, &decoded.error);
+	}
+	else if (request.type == df::ResourceType::SOUND) {
+		sf::InputSoundFile file;
+		const char* p_data = NULL;
+		size_t size = 0;
+		bool opened = m_pack.find(request.filename, &p_data, &size) ? file.openFromMemory(p_data, size) : file.openFromFile(request.filename);
+		if (!opened) {
+			decoded.error = "cannot open sound '" + request.filename + "'.";
+			return decoded;
+		}
+		decoded.samples.resize((size_t)file.getSampleCount());
+		if (!decoded.samples.empty()) {
+			decoded.samples.resize((size_t)file.read(decoded.samples.data(), decoded.samples.size()));
+		}
+		decoded.channel_count = file.getChannelCount();
+		decoded.sample_rate = file.getSampleRate();
 	}
-	data = readData(&file, BODY_TOKEN);
-	for (int i = 0; i < sprite->getFrameCount(); i++) {
-		df::Frame frame = matchFrame(&data, sprite->getWidth(), sprite->getHeight());
-		if (frame.getWidth() == 0 && frame.getHeight() == 0 && frame.getString() == "" && frame.getTransparency() == 0) { // Is an empty frame
-			writeLog("ERROR", "Error loading %s sprite: %d frame not declared properly in %s", label.c_str(), i, BODY_TOKEN);
+	// Music is streamed, so there is nothing to decode up front. It is opened on registration.
+	return decoded;
+}
+
+int df::ResourceManager::registerDecoded(const df::LoadRequest& request, df::ResourceManager::DecodedResource* p_decoded) {
+	const std::string& label = request.label;
+	if (request.type == df::ResourceType::SPRITE) {
+		if (!p_decoded->p_sprite) {
+			writeLog("ERROR", "Error loading %s sprite: %s", label.c_str(), p_decoded->error.c_str());
 			writeLog("ALERT", "Sprite '%s' not loaded.", label.c_str());
-			delete sprite;
-			file.close();
 			return -1;
 		}
-		sprite->addFrame(frame);
+		int slot = reserveSlot(&m_sprite_index, &m_sprite_count, MAX_SPRITES, label);
+		if (slot == -1 || p_sprite[slot]) {
+			writeLog("ERROR", "Cannot load sprite with label '%s'. '%s' already loaded.", label.c_str(), label.c_str());
+			delete p_decoded->p_sprite;
+			p_decoded->p_sprite = NULL;
+			return -1;
+		}
+		p_decoded->p_sprite->setLabel(label);
+		p_sprite[slot] = p_decoded->p_sprite;
+		p_decoded->p_sprite = NULL;
+		writeLog("", "Sprite '%s' loaded.", label.c_str());
+		return 0;
+	}
+	if (request.type == df::ResourceType::SOUND) {
+		if (!p_decoded->error.empty()) {
+			writeLog("ALERT", "Unable to load sound '%s': %s", label.c_str(), p_decoded->error.c_str());
+			return -1;
+		}
+		int slot = reserveSlot(&m_sound_index, &m_sound_count, MAX_SOUNDS, label);
+		if (slot == -1 || m_sound[slot].getLoaded()) {
+			writeLog("ALERT", "Cannot load sound with label '%s'. '%s' already loaded.", label.c_str(), label.c_str());
+			return -1;
+		}
+		m_sound[slot].setLabel(label);
+		if (m_sound[slot].loadSoundFromSamples(p_decoded->samples.data(), p_decoded->samples.size(), p_decoded->channel_count, p_decoded->sample_rate) == -1) {
+			writeLog("ALERT", "Unable to load sound '%s' from file '%s'.", label.c_str(), request.filename.c_str());
+			return -1;
+		}
+		writeLog("", "Sound '%s' loaded.", label.c_str());
+		return 0;
 	}
-	// Not using data in footer.
-	// data = readData(&file, FOOTER_TOKEN);
-	file.close();
-	sprite->setLabel(label);
-	p_sprite[m_sprite_count] = sprite;
-	m_sprite_count++;
-	writeLog("", "Sprite '%s' loaded.", label.c_str());
-	return 0;
+	return loadMusic(request.filename, label);
 }
 
-std::vector<std::string> df::ResourceManager::readData(std::ifstream* p_file, std::string delimiter) {
-	std::vector<std::string> data;
-	std::string begin = "<" + delimiter + ">", end = "</" + delimiter + ">", s = getLine(p_file);
-	if (s != begin) {
-		writeLog("ERROR", "Sprite Error: %s not defined.", delimiter.c_str());
-		data.clear();
-		return data;
+int df::ResourceManager::loadSprite(std::string filename, std::string label) {
+	writeLog("", "Loading sprite '%s'.", label.c_str());
+	int slot = reserveSlot(&m_sprite_index, &m_sprite_count, MAX_SPRITES, label);
+	if (slot == -1) {
+		writeLog("ERROR", "Unable to load sprite '%s'. Sprite array full.", label.c_str());
+		return -1;
 	}
-	s = df::getLine(p_file);
-	while (s != end && !s.empty()) {
-		data.push_back(s);
-		s = getLine(p_file);
+	if (p_sprite[slot]) {
+		writeLog("ERROR", "Cannot load sprite with label '%s'. '%s' already loaded.", label.c_str(), label.c_str());
+		return -1;
 	}
-	if (s.empty()) {
-		writeLog("ERROR", "Sprite Error: %s not closed.", delimiter.c_str());
-		data.clear();
-		return data;
+	writeLog("", "Loading file '%s'.", filename.c_str());
+	std::string error;
+	df::Sprite* sprite = readSprite(filename, &error);
+	if (!sprite) {
+		writeLog("ERROR", "Error loading %s sprite: %s", label.c_str(), error.c_str());
+		writeLog("ALERT", "Sprite '%s' not loaded.", label.c_str());
+		return -1;
 	}
-	return data;
+	sprite->setLabel(label);
+	p_sprite[slot] = sprite;
+	writeLog("", "Sprite '%s' loaded.", label.c_str());
+	return 0;
 }
 
-int df::ResourceManager::matchLineInt(std::vector<std::string>* p_data, const char* token) {
-	auto i = p_data->begin();
-	int number = -1;
-	while (i != p_data->end()) {
-		if (i->compare(0, strlen(token), token) == 0) {
-			number = atoi(i->substr(std::strlen(token) + 1).c_str());
-			i = p_data->erase(i);
+int df::ResourceManager::loadPrefabs(std::string filename) {
+	writeLog("", "Loading prefabs from '%s'.", filename.c_str());
+	const char* p_data = NULL;
+	size_t size = 0;
+	std::vector<char> buffer;
+	if (!m_pack.find(filename, &p_data, &size)) {
+		std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+		if (!file.good()) {
+			writeLog("ERROR", "Error loading prefabs: cannot open file '%s'.", filename.c_str());
+			return -1;
 		}
-		else {
-			i++;
+		buffer.resize((size_t)file.tellg());
+		file.seekg(0);
+		if (!buffer.empty() && !file.read(buffer.data(), buffer.size())) {
+			writeLog("ERROR", "Error loading prefabs: cannot read file '%s'.", filename.c_str());
+			return -1;
 		}
+		p_data = buffer.data();
+		size = buffer.size();
 	}
-	return number;
-}
-
-std::string df::ResourceManager::matchLineStr(std::vector<std::string>* p_data, const char* token) {
-	auto i = p_data->begin();
-	std::string s = "";
-	while (i != p_data->end()) {
-		if (i->compare(0, strlen(token), token) == 0) {
-			s = i->substr(strlen(token) + 1).c_str();
-			i = p_data->erase(i);
+	std::vector<df::Prefab> prefabs;
+	std::string error;
+	if (df::parsePrefabs(p_data, size, &prefabs, &error) == -1) {
+		writeLog("ERROR", "Error loading prefabs from '%s': %s", filename.c_str(), error.c_str());
+		return -1;
+	}
+	for (size_t i = 0; i < prefabs.size(); i++) {
+		df::Prefab& prefab = prefabs[i];
+		if (!prefab.sprite_label.empty()) {
+			prefab.sprite = getSpriteHandle(prefab.sprite_label);
+		}
+		auto it = m_prefab_index.find(prefab.label);
+		if (it != m_prefab_index.end()) {
+			m_prefabs[it->second] = prefab;
 		}
 		else {
-			i++;
+			m_prefab_index[prefab.label] = (int)m_prefabs.size();
+			m_prefabs.push_back(prefab);
 		}
 	}
-	return s;
+	writeLog("", "%d prefabs loaded.", (int)prefabs.size());
+	return 0;
 }
 
-df::Frame df::ResourceManager::matchFrame(std::vector<std::string>* p_data, int width, int height) {
-	if (p_data->empty()) {
-		writeLog("ERROR", "Error loading sprite frame: Frame does not exist.");
-		return df::Frame();
+const df::Prefab* df::ResourceManager::getPrefab(const std::string& label) const {
+	auto it = m_prefab_index.find(label);
+	if (it == m_prefab_index.end()) {
+		return NULL;
 	}
-	std::string line, frame_str = "";
-	for (int i = 1; i <= height; i++) {
-		line = p_data->front();
-		if (line.length() != width) {
-			return df::Frame();
-		}
-		p_data->erase(p_data->begin());
-		frame_str += line;
+	return &m_prefabs[it->second];
+}
+
+df::Sprite* df::ResourceManager::readSprite(const std::string& filename, std::string* p_error) const {
+	const char* p_data = NULL;
+	size_t size = 0;
+	if (m_pack.find(filename, &p_data, &size)) {
+		// Compiled sprites are used in place out of the mapped pack.
+		return decodeSprite(p_data, size, NULL, p_error);
+	}
+	// Read the whole file in one go. Compiled sprites are then used in place out of this buffer.
+	std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+	if (!file.good()) {
+		*p_error = "cannot open file '" + filename + "'.";
+		return NULL;
 	}
-	line = p_data->front();
-	if (line != END_FRAME_TOKEN) {
-		return df::Frame();
+	std::vector<char> buffer((size_t)file.tellg());
+	file.seekg(0);
+	if (!buffer.empty() && !file.read(buffer.data(), buffer.size())) {
+		*p_error = "cannot read file '" + filename + "'.";
+		return NULL;
 	}
-	p_data->erase(p_data->begin());
-	return df::Frame(width, height, frame_str);
+	return decodeSprite(buffer.data(), buffer.size(), &buffer, p_error);
+}
+
+df::Sprite* df::ResourceManager::decodeSprite(const char* p_data, size_t size, std::vector<char>* p_storage, std::string* p_error) const {
+	if (df::isSpriteBinary(p_data, size)) {
+		df::SpriteFileHeader header;
+		std::vector<unsigned int> frame_offset;
+		const char* p_glyphs = NULL;
+		if (df::readSpriteBinary(p_data, size, &header, &frame_offset, &p_glyphs, p_error) == -1) {
+			return NULL;
+		}
+		df::Sprite* sprite = new df::Sprite(header.frame_count);
+		sprite->setWidth(header.width);
+		sprite->setHeight(header.height);
+		sprite->setColor((df::Color)header.color);
+		sprite->setTransparent((char)header.transparent);
+		sprite->setSlowdown(header.slowdown);
+		if (p_storage) {
+			sprite->holdStorage(p_storage);
+		}
+		sprite->setFrames(p_glyphs, frame_offset);
+		return sprite;
+	}
+	df::SpriteData data;
+	if (df::parseSpriteText(p_data, size, &data, p_error) == -1) {
+		return NULL;
+	}
+	df::Sprite* sprite = new df::Sprite(data.frame_count);
+	sprite->setWidth(data.width);
+	sprite->setHeight(data.height);
+	sprite->setColor(data.color);
+	sprite->setTransparent(data.transparent);
+	sprite->setSlowdown(data.slowdown);
+	const char* p_glyphs = data.glyphs.data();
+	sprite->holdStorage(&data.glyphs);
+	sprite->setFrames(p_glyphs, data.frame_offset);
+	return sprite;
 }
 
 int df::ResourceManager::unloadSprite(std::string label) {
 	writeLog("", "Unloading sprite '%s'.", label.c_str());
-	for (int i = 0; i < m_sprite_count; i++) {
-		if (p_sprite[i] != NULL) {
-			if (label == p_sprite[i]->getLabel()) {
-				delete p_sprite[i];
-				for (int j = i; j < m_sprite_count - 1; j++) {
-					p_sprite[j] = p_sprite[j + 1];
-				}
-				m_sprite_count--;
-				writeLog("", "Sprite '%s' unloaded.", label.c_str());
-				return 0;
-			}
-		}
+	auto it = m_sprite_index.find(label);
+	if (it != m_sprite_index.end() && p_sprite[it->second] != NULL) {
+		// Slot stays reserved so handles to it remain valid.
+		delete p_sprite[it->second];
+		p_sprite[it->second] = NULL;
+		writeLog("", "Sprite '%s' unloaded.", label.c_str());
+		return 0;
 	}
 	writeLog("ALERT", "Cannot unload sprite '%s'. Sprite not found.", label.c_str());
 	return -1;
 }
 
-df::Sprite* df::ResourceManager::getSprite(std::string label) const {
-	for (int i = 0; i < m_sprite_count; i++) {
-		if (label == p_sprite[i]->getLabel()) {
-			return p_sprite[i];
-		}
+df::Sprite* df::ResourceManager::getSprite(const std::string& label) const {
+	auto it = m_sprite_index.find(label);
+	if (it == m_sprite_index.end()) {
+		return NULL;
+	}
+	return p_sprite[it->second];
+}
+
+df::SpriteHandle df::ResourceManager::getSpriteHandle(const std::string& label) {
+	int slot = reserveSlot(&m_sprite_index, &m_sprite_count, MAX_SPRITES, label);
+	if (slot == -1) {
+		writeLog("ERROR", "Unable to get handle for sprite '%s'. Sprite array full.", label.c_str());
+		return df::SpriteHandle();
+	}
+	return df::SpriteHandle(slot);
+}
+
+df::Sprite* df::ResourceManager::getSprite(df::SpriteHandle handle) const {
+	if (!handle.isValid() || handle.getIndex() >= m_sprite_count) {
+		return NULL;
 	}
-	return NULL;
+	return p_sprite[handle.getIndex()];
 }
 
 int df::ResourceManager::loadSound(std::string filename, std::string label) {
 	writeLog("", "Loading sound '%s'", label.c_str());
-	if (m_sound_count >= MAX_SOUNDS) {
-		writeLog("ERROR", "ALERT", "Unable to load sound '%s'. Sound array full.", label.c_str());
+	int slot = reserveSlot(&m_sound_index, &m_sound_count, MAX_SOUNDS, label);
+	if (slot == -1) {
+		writeLog("ERROR", "Unable to load sound '%s'. Sound array full.", label.c_str());
 		return -1;
 	}
-	for (int i = 0; i < m_sound_count; i++) {
-		if (label == m_sound[i].getLabel()) {
-			writeLog("ALERT", "Cannot load sound with label '%s'. '%s' already loaded.", label.c_str(), label.c_str());
+	if (m_sound[slot].getLoaded()) {
+		writeLog("ALERT", "Cannot load sound with label '%s'. '%s' already loaded.", label.c_str(), label.c_str());
+		return -1;
+	}
+	m_sound[slot].setLabel(label);
+	const char* p_data = NULL;
+	size_t size = 0;
+	if (m_pack.find(filename, &p_data, &size)) {
+		if (m_sound[slot].loadSoundFromMemory(p_data, size) == -1) {
+			writeLog("ALERT", "Unable to load sound '%s' from pack entry '%s'.", label.c_str(), filename.c_str());
 			return -1;
 		}
 	}
-	if (m_sound[m_sound_count].loadSound(filename) == -1) {
+	else if (m_sound[slot].loadSound(filename) == -1) {
 		writeLog("ALERT", "Unable to load sound '%s' from file '%s'.", label.c_str(), filename.c_str());
 		return -1;
 	}
-	m_sound[m_sound_count].setLabel(label);
-	m_sound_count++;
 	writeLog("", "Sound '%s' loaded.", label.c_str());
 	return 0;
 }
 
 int df::ResourceManager::unloadSound(std::string label) {
 	writeLog("", "Unloading sound '%s'.", label.c_str());
-	for (int i = 0; i < m_sound_count; i++) {
-		if (label == m_sound[i].getLabel()) {
-			for (int j = i; j < m_sound_count - 1; j++) {
-				m_sound[j] = m_sound[j + 1];
-			}
-			m_sound_count--;
-			writeLog("", "Sound '%s' unloaded.", label.c_str());
-			return 0;
-		}
+	auto it = m_sound_index.find(label);
+	if (it != m_sound_index.end() && m_sound[it->second].getLoaded()) {
+		// Slot stays reserved so handles to it remain valid.
+		m_sound[it->second].stop();
+		m_sound[it->second].setLoaded(false);
+		writeLog("", "Sound '%s' unloaded.", label.c_str());
+		return 0;
 	}
 	writeLog("ALERT", "Cannot unload sound '%s'. Sound not found.", label.c_str());
 	return -1;
 }
 
-df::Sound* df::ResourceManager::getSound(std::string label) {
-	for (int i = 0; i < m_sound_count; i++) {
-		if (label == m_sound[i].getLabel()) {
-			return &m_sound[i];
-		}
+df::Sound* df::ResourceManager::getSound(const std::string& label) {
+	auto it = m_sound_index.find(label);
+	if (it == m_sound_index.end()) {
+		return NULL;
 	}
-	return NULL;
+	return getSound(df::SoundHandle(it->second));
+}
+
+df::SoundHandle df::ResourceManager::getSoundHandle(const std::string& label) {
+	int slot = reserveSlot(&m_sound_index, &m_sound_count, MAX_SOUNDS, label);
+	if (slot == -1) {
+		writeLog("ERROR", "Unable to get handle for sound '%s'. Sound array full.", label.c_str());
+		return df::SoundHandle();
+	}
+	m_sound[slot].setLabel(label);
+	return df::SoundHandle(slot);
+}
+
+df::Sound* df::ResourceManager::getSound(df::SoundHandle handle) {
+	if (!handle.isValid() || handle.getIndex() >= m_sound_count || !m_sound[handle.getIndex()].getLoaded()) {
+		return NULL;
+	}
+	return &m_sound[handle.getIndex()];
 }
 
 int df::ResourceManager::loadMusic(std::string filename, std::string label) {
 	writeLog("", "Loading music '%s'", label.c_str());
-	if (m_music_count >= MAX_MUSICS) {
-		writeLog("ERROR", "ALERT", "Unable to load music '%s'. Sound array full.", label.c_str());
+	int slot = reserveSlot(&m_music_index, &m_music_count, MAX_MUSICS, label);
+	if (slot == -1) {
+		writeLog("ERROR", "Unable to load music '%s'. Music array full.", label.c_str());
 		return -1;
 	}
-	for (int i = 0; i < m_music_count; i++) {
-		if (label == m_music[i].getLabel()) {
-			writeLog("ALERT", "Cannot load music with label '%s'. '%s' already loaded.", label.c_str(), label.c_str());
+	if (m_music[slot].getLoaded()) {
+		writeLog("ALERT", "Cannot load music with label '%s'. '%s' already loaded.", label.c_str(), label.c_str());
+		return -1;
+	}
+	m_music[slot].setLabel(label);
+	const char* p_data = NULL;
+	size_t size = 0;
+	if (m_pack.find(filename, &p_data, &size)) {
+		// Streamed straight out of the mapped pack.
+		if (m_music[slot].loadMusicFromMemory(p_data, size) == -1) {
+			writeLog("ALERT", "Unable to load music '%s' from pack entry '%s'.", label.c_str(), filename.c_str());
 			return -1;
 		}
 	}
-	if (m_music[m_music_count].loadMusic(filename) == -1) {
+	else if (m_music[slot].loadMusic(filename) == -1) {
 		writeLog("ALERT", "Unable to load music '%s' from file '%s'.", label.c_str(), filename.c_str());
 		return -1;
 	}
-	m_music[m_music_count].setLabel(label);
-	m_music_count++;
 	writeLog("", "Music '%s' loaded.", label.c_str());
 	return 0;
 }
 
 int df::ResourceManager::unloadMusic(std::string label) {
 	writeLog("", "Unloading music '%s'.", label.c_str());
-	for (int i = 0; i < m_music_count; i++) {
-		if (label == m_music[i].getLabel() && m_music[i].getLoaded()) {
-			m_music[i].setLoaded(false);
-			writeLog("", "Music '%s' unloaded.", label.c_str());
-			return 0;
-		}
+	auto it = m_music_index.find(label);
+	if (it != m_music_index.end() && m_music[it->second].getLoaded()) {
+		m_music[it->second].stop();
+		m_music[it->second].setLoaded(false);
+		writeLog("", "Music '%s' unloaded.", label.c_str());
+		return 0;
 	}
 	writeLog("ALERT", "Cannot unload music '%s'. Music not found.", label.c_str());
 	return -1;
 }
 
-df::Music* df::ResourceManager::getMusic(std::string label) {
-	for (int i = 0; i < m_music_count; i++) {
-		if (label == m_music[i].getLabel()) {
-			return &m_music[i];
-		}
+df::Music* df::ResourceManager::getMusic(const std::string& label) {
+	auto it = m_music_index.find(label);
+	if (it == m_music_index.end()) {
+		return NULL;
+	}
+	return getMusic(df::MusicHandle(it->second));
+}
+
+df::MusicHandle df::ResourceManager::getMusicHandle(const std::string& label) {
+	int slot = reserveSlot(&m_music_index, &m_music_count, MAX_MUSICS, label);
+	if (slot == -1) {
+		writeLog("ERROR", "Unable to get handle for music '%s'. Music array full.", label.c_str());
+		return df::MusicHandle();
+	}
+	m_music[slot].setLabel(label);
+	return df::MusicHandle(slot);
+}
+
+df::Music* df::ResourceManager::getMusic(df::MusicHandle handle) {
+	if (!handle.isValid() || handle.getIndex() >= m_music_count || !m_music[handle.getIndex()].getLoaded()) {
+		return NULL;
 	}
-	return NULL;
+	return &m_music[handle.getIndex()];
 }
\ No newline at end of file
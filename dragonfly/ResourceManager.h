@@ -9,29 +9,27 @@
 
 // System includes.
 #include <SFML/Audio.hpp>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 // Engine includes.
+#include "AssetPack.h"
 #include "Manager.h"
 #include "Music.h"
+#include "Prefab.h"
+#include "ResourceHandle.h"
 #include "Sound.h"
 #include "Sprite.h"
+#include "SpriteFile.h"
 
 // Two-letter acronym for easier access to manager.
 #define RM df::ResourceManager::getInstance()
 
-// Delimiters used to parse Sprite files
-#define HEADER_TOKEN "HEADER"
-#define BODY_TOKEN "BODY"
-#define FOOTER_TOKEN "FOOTER"
-#define FRAMES_TOKEN "frames"
-#define HEIGHT_TOKEN "height"
-#define WIDTH_TOKEN "width"
-#define COLOR_TOKEN "color"
-#define SLOWDOWN_TOKEN "slowdown"
-#define END_FRAME_TOKEN "end"
-#define VERSION_TOKEN "version"
-
 namespace df {
 
 	// Maximum number of unique assets in game.
@@ -39,22 +37,80 @@ namespace df {
 	const int MAX_SOUNDS = 128;
 	const int MAX_MUSICS = 128;
 
+	// Kinds of resource the ResourceManager holds.
+	enum class ResourceType {
+		SPRITE,
+		SOUND,
+		MUSIC,
+	};
+
+	// Request to load one resource in the background (see ResourceManager::loadBatch()).
+	struct LoadRequest {
+		ResourceType type;
+		std::string filename;
+		std::string label;
+		std::function<void(int)> on_done; // Optional. Called on the main thread with 0 if loaded, else -1.
+
+		LoadRequest(ResourceType new_type, std::string new_filename, std::string new_label, std::function<void(int)> new_on_done = nullptr);
+	};
+
 	class ResourceManager : public Manager {
 
 	private:
 		ResourceManager(ResourceManager const&); // Don't allow copy.
 		void operator=(ResourceManager const&);  // Don't allow assignment.
 		ResourceManager();		 // Private since a singleton.
-		std::vector<std::string> readData(std::ifstream* p_file, std::string delimiter); // Read in next section of data from file as vector of strings. Return vector (empty if error).
-		int matchLineInt(std::vector<std::string>* p_data, const char* token); // Match token in vector of lines (e.g., "frames 5"). Return corresponding value (e.g., 5) (-1 if not found). Remove any line that matches from vector.
-		std::string matchLineStr(std::vector<std::string>* p_data, const char* token); // Match token in vector of lines (e.g., "frames 5"). Return corresponding value (e.g., "green") ("" if not found). Remove any line that matches from vector.
-		Frame matchFrame(std::vector<std::string>* p_data, int width, int height); // Match frame lines until "end", clearing all from vector. Return Frame.
-		Sprite* p_sprite[MAX_SPRITES]; // Array of (pointers to) Sprites.
-		int m_sprite_count;	         // Count of number of loaded sprites.
+		// Build Sprite from sprite file contents (compiled or text) in p_data.
+		// Compiled glyphs are used in place, so p_data must outlive the Sprite unless it points into p_storage,
+		// which the Sprite then takes ownership of (may be NULL).
+		// Return new Sprite, or NULL with reason in p_error.
+		Sprite* decodeSprite(const char* p_data, size_t size, std::vector<char>* p_storage, std::string* p_error) const;
+		// Return slot index for label, reserving a new slot if label not seen before.
+		// Return -1 if no slots left.
+		int reserveSlot(std::unordered_map<std::string, int>* p_index, int* p_count, int max_count, const std::string& label);
+		Sprite* p_sprite[MAX_SPRITES]; // Array of (pointers to) Sprites. NULL if slot not loaded.
+		int m_sprite_count;	         // Count of number of sprite slots in use.
 		Sound m_sound[MAX_SOUNDS];	 // Array of sound buffers.
-		int m_sound_count;	         // Count of number of loaded sounds.
+		int m_sound_count;	         // Count of number of sound slots in use.
 		Music m_music[MAX_MUSICS];	 // Array of music buffers.
-		int m_music_count;	         // Count of number of loaded musics.
+		int m_music_count;	         // Count of number of music slots in use.
+		std::unordered_map<std::string, int> m_sprite_index; // Sprite label to slot.
+		std::unordered_map<std::string, int> m_sound_index;  // Sound label to slot.
+		std::unordered_map<std::string, int> m_music_index;  // Music label to slot.
+		AssetPack m_pack; // Asset pack resources are looked up in first (if open).
+		std::deque<Prefab> m_prefabs; // Loaded prefabs. A deque, so pointers handed out stay valid.
+		std::unordered_map<std::string, int> m_prefab_index; // Prefab label to index in m_prefabs.
+
+		// Resource parsed or decoded on a worker thread, waiting to be registered on the main thread.
+		struct DecodedResource {
+			Sprite* p_sprite;                 // Sprite (SPRITE).
+			std::vector<sf::Int16> samples;   // Decoded samples (SOUND).
+			unsigned int channel_count;       // Sample channels (SOUND).
+			unsigned int sample_rate;         // Sample rate (SOUND).
+			std::string error;                // Reason if decoding failed.
+			DecodedResource();
+		};
+
+		// Background load that hasn't been registered yet.
+		struct PendingLoad {
+			LoadRequest request;
+			std::future<DecodedResource> decoded; // Ready once the worker is done.
+			std::promise<int> done;               // Fulfilled once registered.
+			PendingLoad(const LoadRequest& new_request);
+		};
+		std::vector<PendingLoad> m_pending; // Background loads in request order.
+
+		// Read sprite from pack or file.
+		// Touches no manager state other than the pack, so it is safe on worker threads.
+		// Return new Sprite, or NULL with reason in p_error.
+		Sprite* readSprite(const std::string& filename, std::string* p_error) const;
+
+		// Parse or decode requested resource. Runs on a worker thread, so doesn't log or touch slots.
+		DecodedResource decode(const LoadRequest& request) const;
+
+		// Put decoded resource into its slot. Main thread only.
+		// Return 0 if ok, else -1.
+		int registerDecoded(const LoadRequest& request, DecodedResource* p_decoded);
 	public:
 		// Get the one and only instance of the ResourceManager.
 		static ResourceManager& getInstance();
@@ -65,7 +121,32 @@ namespace df {
 		// Shut down manager, freeing up any allocated Sprites, Music and Sounds.
 		void shutDown();
 
+		// Map asset pack (see AssetPack.h) that later loads look in before the file system.
+		// Filenames passed to load functions are looked up by name in the pack.
+		// Return 0 if ok, else -1 (loads then use files only).
+		int openPack(std::string filename);
+
+		// Unmap asset pack. Anything loaded from it must be unloaded first.
+		void closePack();
+
+		// Start loading resources as JobManager background jobs (parsing sprites and decoding sounds).
+		// If the JobManager is not started, they are decoded right away.
+		// Slots are reserved right away, so handles can be taken before the loads finish.
+		// Results are registered on the main thread by update(), which fulfils the returned futures
+		// (one per request, 0 if loaded, else -1) and calls each request's on_done.
+		std::vector<std::shared_future<int>> loadBatch(const std::vector<LoadRequest>& requests);
+
+		// Register background loads that have finished. Called by GameManager every frame.
+		void update();
+
+		// Return number of background loads not yet registered.
+		int getPendingCount() const;
+
+		// Wait for and register all background loads.
+		void finishLoading();
+
 		// Load Sprite from file.
+		// File may be a compiled sprite (see SpriteFile.h) or the text format.
 		// Assign indicated label to Sprite.
 		// Return 0 if ok, else -1.
 		int loadSprite(std::string filename, std::string label);
@@ -76,7 +157,16 @@ namespace df {
 
 		// Find Sprite with indicated label.
 		// Return pointer to it if found, else NULL.
-		Sprite* getSprite(std::string label) const;
+		Sprite* getSprite(const std::string& label) const;
+
+		// Return handle for Sprite with indicated label.
+		// The slot is reserved if the label hasn't been loaded yet and is filled when it is.
+		// Return invalid handle if no slots left.
+		SpriteHandle getSpriteHandle(const std::string& label);
+
+		// Find Sprite for handle.
+		// Return pointer to it if loaded, else NULL.
+		Sprite* getSprite(SpriteHandle handle) const;
 
 		// Load sound from file.
 		// Return 0 if ok, else -1.
@@ -88,7 +178,16 @@ namespace df {
 
 		// Find Sound with indicated label.
 		// Return pointer to it if found, else NULL.
-		Sound* getSound(std::string label);
+		Sound* getSound(const std::string& label);
+
+		// Return handle for Sound with indicated label.
+		// The slot is reserved if the label hasn't been loaded yet and is filled when it is.
+		// Return invalid handle if no slots left.
+		SoundHandle getSoundHandle(const std::string& label);
+
+		// Find Sound for handle.
+		// Return pointer to it if loaded, else NULL.
+		Sound* getSound(SoundHandle handle);
 
 		// Associate file with Music.
 		// Return 0 if ok, else -1.
@@ -101,7 +200,26 @@ namespace df {
 
 		// Find Music with indicated label.
 		// Return pointer to it if found, else NULL.
-		Music* getMusic(std::string label);
+		Music* getMusic(const std::string& label);
+
+		// Return handle for Music with indicated label.
+		// The slot is reserved if the label hasn't been loaded yet and is filled when it is.
+		// Return invalid handle if no slots left.
+		MusicHandle getMusicHandle(const std::string& label);
+
+		// Find Music for handle.
+		// Return pointer to it if loaded, else NULL.
+		Music* getMusic(MusicHandle handle);
+
+		// Load prefab definitions (see Prefab.h) from file.
+		// Sprites are resolved to handles now, so they may still be loading.
+		// A label loaded again is replaced.
+		// Return 0 if ok, else -1.
+		int loadPrefabs(std::string filename);
+
+		// Find prefab with indicated label.
+		// Return pointer to it if found, else NULL.
+		const Prefab* getPrefab(const std::string& label) const;
 	};
 
 } // end of namespace df
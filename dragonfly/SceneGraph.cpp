@@ -10,6 +10,25 @@
 #include "LogManager.h"
 #include "utility.h"
 
+// System includes.
+#include <algorithm>
+
+namespace {
+
+	// Remove p_o from list by swapping in the last element.
+	// Return true if p_o was in list.
+	bool removeUnordered(std::vector<df::Object*>* p_list, const df::Object* p_o) {
+		for (size_t i = 0; i < p_list->size(); i++) {
+			if ((*p_list)[i] == p_o) {
+				(*p_list)[i] = p_list->back();
+				p_list->pop_back();
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
 df::SceneGraph::SceneGraph() {
 	m_active_objects;
 	m_inactive_objects;
@@ -23,105 +42,204 @@ int df::SceneGraph::insertObject(df::Object* p_o) {
 		LM.writeLog("ERROR", "SceneGraph", "Error inserting object. Object altitude not in range.");
 		return -1;
 	}
-	df::ObjectList ol = m_active_objects + m_inactive_objects;
-	df::ObjectListIterator li(&ol);
-	li.first();
-	while (!li.isDone() && li.currentObject()) {
-		if (li.currentObject() == p_o) {
-			return 0; // Already inserted.
-		}
-		li.next();
+	if (!m_members.insert(p_o).second) {
+		return 0; // Already inserted.
 	}
+	// Membership is tracked by m_members, so the lists need no duplicate scan.
 	if (p_o->isActive()) {
-		m_active_objects.insert(p_o);
+		m_active_objects.append(p_o);
 	}
 	else {
-		m_inactive_objects.insert(p_o);
+		m_inactive_objects.append(p_o);
 	}
 	if (p_o->isSolid()) {
-		m_solid_objects.insert(p_o);
+		m_solid_objects.append(p_o);
+	}
+	m_visible_objects[p_o->getAltitude()].append(p_o);
+	if (p_o->getTypeId() >= (df::StringId)m_by_type.size()) {
+		m_by_type.resize(p_o->getTypeId() + 1);
 	}
-	m_visible_objects[p_o->getAltitude()].insert(p_o);
+	m_by_type[p_o->getTypeId()].push_back(p_o);
 	return 0;
 }
 
-int df::SceneGraph::removeObject(df::Object* p_o) {
-	if (m_active_objects.remove(p_o) == 0) {
+int df::SceneGraph::insertObjects(const std::vector<df::Object*>& objects) {
+	// Filter first, so each list can be sized exactly before filling.
+	std::vector<df::Object*> fresh;
+	fresh.reserve(objects.size());
+	m_members.reserve(m_members.size() + objects.size());
+	int active = 0, solid = 0;
+	int visible[df::MAX_ALTITUDE + 1] = {};
+	for (size_t i = 0; i < objects.size(); i++) {
+		df::Object* p_o = objects[i];
+		if (!df::valueInRange(p_o->getAltitude(), 0, df::MAX_ALTITUDE)) {
+			LM.writeLog("ERROR", "SceneGraph", "Error inserting object '%s %d'. Object altitude not in range.", p_o->getType().c_str(), p_o->getId());
+			continue;
+		}
+		if (!m_members.insert(p_o).second) {
+			continue; // Already inserted.
+		}
+		fresh.push_back(p_o);
+		active += p_o->isActive() ? 1 : 0;
+		solid += p_o->isSolid() ? 1 : 0;
+		visible[p_o->getAltitude()]++;
+		if (p_o->getTypeId() >= (df::StringId)m_by_type.size()) {
+			m_by_type.resize(p_o->getTypeId() + 1);
+		}
+	}
+	m_active_objects.reserve(m_active_objects.getCount() + active);
+	m_inactive_objects.reserve(m_inactive_objects.getCount() + (int)fresh.size() - active);
+	m_solid_objects.reserve(m_solid_objects.getCount() + solid);
+	for (int i = 0; i < df::MAX_ALTITUDE + 1; i++) {
+		m_visible_objects[i].reserve(m_visible_objects[i].getCount() + visible[i]);
+	}
+	for (size_t i = 0; i < fresh.size(); i++) {
+		df::Object* p_o = fresh[i];
+		if (p_o->isActive()) {
+			m_active_objects.append(p_o);
+		}
+		else {
+			m_inactive_objects.append(p_o);
+		}
 		if (p_o->isSolid()) {
-			m_solid_objects.remove(p_o);
+			m_solid_objects.append(p_o);
 		}
-		m_visible_objects[p_o->getAltitude()].remove(p_o);
-		return 0;
+		m_visible_objects[p_o->getAltitude()].append(p_o);
+		m_by_type[p_o->getTypeId()].push_back(p_o);
+	}
+	LM.writeLog("", "SceneGraph", "Inserted %d objects.", (int)fresh.size());
+	return (int)fresh.size();
+}
+
+int df::SceneGraph::removeObject(df::Object* p_o) {
+	if (m_members.erase(p_o) == 0) {
+		return -1;
+	}
+	removeUnordered(&m_by_type[p_o->getTypeId()], p_o);
+	if (m_active_objects.remove(p_o) != 0) {
+		m_inactive_objects.remove(p_o);
+	}
+	if (p_o->isSolid()) {
+		m_solid_objects.remove(p_o);
+	}
+	m_visible_objects[p_o->getAltitude()].remove(p_o);
+	return 0;
+}
+
+void df::SceneGraph::removeMarked() {
+	m_active_objects.removeMarked();
+	m_inactive_objects.removeMarked();
+	m_solid_objects.removeMarked();
+	for (int i = 0; i < df::MAX_ALTITUDE + 1; i++) {
+		m_visible_objects[i].removeMarked();
+	}
+	for (size_t i = 0; i < m_by_type.size(); i++) {
+		std::vector<df::Object*>& same_type = m_by_type[i];
+		same_type.erase(std::remove_if(same_type.begin(), same_type.end(), [this](const df::Object* p_o) {
+			if (!p_o->isMarkedForDelete()) {
+				return false;
+			}
+			m_members.erase(p_o);
+			return true;
+		}), same_type.end());
 	}
-	return -1;
 }
 
-df::ObjectList df::SceneGraph::activeObjects() const {
+void df::SceneGraph::clear() {
+	m_active_objects.clear();
+	m_inactive_objects.clear();
+	m_solid_objects.clear();
+	for (int i = 0; i < df::MAX_ALTITUDE + 1; i++) {
+		m_visible_objects[i].clear();
+	}
+	m_by_type.clear();
+	m_members.clear();
+}
+
+const df::ObjectList& df::SceneGraph::activeObjects() const {
 	return m_active_objects;
 }
 
-df::ObjectList df::SceneGraph::solidObjects() const {
+const df::ObjectList& df::SceneGraph::solidObjects() const {
 	return m_solid_objects;
 }
 
-df::ObjectList df::SceneGraph::visibleObjects(int altitude) const {
+const df::ObjectList& df::SceneGraph::visibleObjects(int altitude) const {
 	return m_visible_objects[altitude];
 }
 
-df::ObjectList df::SceneGraph::inactiveObjects() const {
+const df::ObjectList& df::SceneGraph::inactiveObjects() const {
 	return m_inactive_objects;
 }
 
-int df::SceneGraph::updateAltitude(df::Object* p_o, int new_alt) {
-	if (!df::valueInRange(new_alt, 0, df::MAX_ALTITUDE)) {
-		LM.writeLog("ERROR", "SceneGraph", "Error inserting object. Object altitude not in range.");
+const std::vector<df::Object*>& df::SceneGraph::objectsOfType(df::StringId type) const {
+	static const std::vector<df::Object*> none;
+	if (type < 0 || type >= (df::StringId)m_by_type.size()) {
+		return none;
+	}
+	return m_by_type[type];
+}
+
+bool df::SceneGraph::contains(const df::Object* p_o) const {
+	return m_members.count(p_o) != 0;
+}
+
+int df::SceneGraph::updateType(df::Object* p_o, df::StringId old_type) {
+	if (p_o->getTypeId() == old_type || old_type < 0 || old_type >= (df::StringId)m_by_type.size()) {
+		return 0; // Type hasn't changed or never indexed.
+	}
+	if (!removeUnordered(&m_by_type[old_type], p_o)) {
+		return 0; // Not in SceneGraph (indexed on insert).
+	}
+	if (p_o->getTypeId() >= (df::StringId)m_by_type.size()) {
+		m_by_type.resize(p_o->getTypeId() + 1);
+	}
+	m_by_type[p_o->getTypeId()].push_back(p_o);
+	return 0;
+}
+
+int df::SceneGraph::updateAltitude(df::Object* p_o, int old_alt) {
+	if (!df::valueInRange(p_o->getAltitude(), 0, df::MAX_ALTITUDE)) {
+		LM.writeLog("ERROR", "SceneGraph", "Error updating object. Object altitude not in range.");
 		return -1;
 	}
-	if (p_o->getAltitude() == new_alt) {
+	if (old_alt == p_o->getAltitude()) {
 		return 0; // Altitude hasn't changed
 	}
-	m_visible_objects[p_o->getAltitude()].remove(p_o);
-	m_visible_objects[new_alt].insert(p_o);
+	if (m_visible_objects[old_alt].remove(p_o) == 0) {
+		m_visible_objects[p_o->getAltitude()].insert(p_o);
+	}
 	return 0;
 }
 
-int df::SceneGraph::updateSolidness(df::Object* p_o, df::Solidness new_solidness) {
-	if (p_o->isSolid() == (new_solidness == df::Solidness::HARD || new_solidness == df::Solidness::SOFT)) {
+int df::SceneGraph::updateSolidness(df::Object* p_o, bool was_solid) {
+	if (was_solid == p_o->isSolid()) {
 		return 0; // Solidness hasn't changed
 	}
-	if (p_o->isSolid()) {
-		m_solid_objects.remove(p_o);
-	}
-	if (new_solidness == df::Solidness::HARD || new_solidness == df::Solidness::SOFT) {
-		m_solid_objects.insert(p_o);
+	if (was_solid) {
+		return m_solid_objects.remove(p_o);
 	}
-	return 0;
+	return m_solid_objects.insert(p_o);
 }
 
-int df::SceneGraph::updateVisible(df::Object* p_o, bool new_visible) {
-	if (p_o->isVisible() == new_visible) {
+int df::SceneGraph::updateVisible(df::Object* p_o, bool was_visible) {
+	if (was_visible == p_o->isVisible()) {
 		return 0; // Visibility hasn't changed
 	}
-	if (new_visible) {
-		m_visible_objects[p_o->getAltitude()].insert(p_o);
+	if (was_visible) {
+		return m_visible_objects[p_o->getAltitude()].remove(p_o);
 	}
-	else {
-		m_visible_objects[p_o->getAltitude()].remove(p_o);
-	}
-	return 0;
+	return m_visible_objects[p_o->getAltitude()].insert(p_o);
 }
 
-int df::SceneGraph::updateActive(df::Object* p_o, bool new_active) {
-	if (p_o->isActive() == new_active) {
+int df::SceneGraph::updateActive(df::Object* p_o, bool was_active) {
+	if (was_active == p_o->isActive()) {
 		return 0; // Active hasn't changed
 	}
-	if (p_o->isActive()) {
+	if (was_active) {
 		m_active_objects.remove(p_o);
-		m_inactive_objects.insert(p_o);
+		return m_inactive_objects.insert(p_o);
 	}
-	else {
-		m_inactive_objects.remove(p_o);
-		m_active_objects.insert(p_o);
-	}
-	return 0;
+	m_inactive_objects.remove(p_o);
+	return m_active_objects.insert(p_o);
 }
\ No newline at end of file
@@ -7,7 +7,12 @@
 #ifndef __SCENE_GRAPH_H__
 #define __SCENE_GRAPH_H__
 
+// System includes.
+#include <unordered_set>
+#include <vector>
+
 // Engine includes.
+#include "Intern.h"
 #include "ObjectList.h"
 
 namespace df {
@@ -18,32 +23,52 @@ namespace df {
 		ObjectList m_inactive_objects; // All inactive objects.
 		ObjectList m_solid_objects; // Solid objects.
 		ObjectList m_visible_objects[MAX_ALTITUDE + 1]; // Visible objects
+		std::vector<std::vector<Object*>> m_by_type; // All Objects, indexed by interned type.
+		std::unordered_set<const Object*> m_members; // All Objects, for O(1) contains().
 	public:
 		SceneGraph();
 		// Insert Object into SceneGraph
 		int insertObject(Object* p_o);
+		// Insert many Objects, each list sized once and filled in one pass.
+		// Objects already in SceneGraph or with altitude out of range are skipped.
+		// Return number inserted.
+		int insertObjects(const std::vector<Object*>& objects);
 		// Remove Object from SceneGraph
 		int removeObject(Object* p_o);
+		// Remove all Objects marked for delete (see Object::isMarkedForDelete()).
+		// One pass over each list, so removing many Objects costs the same as removing one.
+		void removeMarked();
+		// Remove all Objects from SceneGraph.
+		void clear();
 		// Return all active Objects. Empty list if none.
-		ObjectList activeObjects() const;
+		const ObjectList& activeObjects() const;
 		// Return all solid Objects. Empty list if none.
-		ObjectList solidObjects() const;
+		const ObjectList& solidObjects() const;
 		// Return all visible Objects. Empty list if none.
-		ObjectList visibleObjects(int altitude) const;
+		const ObjectList& visibleObjects(int altitude) const;
 		// Return all inactive Objects. Empty list if none.
-		ObjectList inactiveObjects() const;
-		// Re-position Object in SceneGraph to new altitude.
+		const ObjectList& inactiveObjects() const;
+		// Return all Objects (active or not) of interned type.
+		const std::vector<Object*>& objectsOfType(StringId type) const;
+		// Return true if Object is in SceneGraph.
+		bool contains(const Object* p_o) const;
+		// The update methods below are called after the Object has changed,
+		// with the value it had when it was last placed in the SceneGraph.
+		// Re-index Object under its current type.
+		// Return 0 if ok, else -1.
+		int updateType(Object* p_o, StringId old_type);
+		// Re-position Object in SceneGraph to its current altitude.
 		// Return 0 if ok, else -1.
-		int updateAltitude(Object* p_o, int new_alt);
-		// Re-position Object in SceneGraph to new altitude.
+		int updateAltitude(Object* p_o, int old_alt);
+		// Add Object to or remove Object from solid list to match its current solidness.
 		// Return 0 if ok, else -1.
-		int updateSolidness(Object* p_o, Solidness new_solidness);
-		// Re-position Object in SceneGraph to new altitude.
+		int updateSolidness(Object* p_o, bool was_solid);
+		// Add Object to or remove Object from visible list to match its current visibility.
 		// Return 0 if ok, else -1.
-		int updateVisible(Object* p_o, bool new_visible);
-		// Re-position Object in SceneGraph to new altitude.
+		int updateVisible(Object* p_o, bool was_visible);
+		// Move Object between active and inactive lists to match its current activity.
 		// Return 0 if ok, else -1.
-		int updateActive(Object* p_o, bool new_active);
+		int updateActive(Object* p_o, bool was_active);
 	};
 } // end of namespace df
 #endif // __SCENE_GRAPH_H__
\ No newline at end of file
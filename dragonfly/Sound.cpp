@@ -13,6 +13,7 @@ df::Sound::Sound() {
 	m_sound = sf::Sound();
 	m_sound_buffer = sf::SoundBuffer();
 	m_label = "";
+	m_loaded = false;
 }
 
 df::Sound::~Sound() {
@@ -26,6 +27,27 @@ int df::Sound::loadSound(std::string filename) {
 		return -1;
 	}
 	m_sound.setBuffer(m_sound_buffer);
+	setLoaded();
+	return 0;
+}
+
+int df::Sound::loadSoundFromMemory(const void* p_data, size_t size) {
+	if (!m_sound_buffer.loadFromMemory(p_data, size)) {
+		LM.writeLog("ERROR", "Sound", "Error loading sound '%s' from memory", m_label.c_str());
+		return -1;
+	}
+	m_sound.setBuffer(m_sound_buffer);
+	setLoaded();
+	return 0;
+}
+
+int df::Sound::loadSoundFromSamples(const sf::Int16* p_samples, sf::Uint64 sample_count, unsigned int channel_count, unsigned int sample_rate) {
+	if (!m_sound_buffer.loadFromSamples(p_samples, sample_count, channel_count, sample_rate)) {
+		LM.writeLog("ERROR", "Sound", "Error loading sound '%s' from samples", m_label.c_str());
+		return -1;
+	}
+	m_sound.setBuffer(m_sound_buffer);
+	setLoaded();
 	return 0;
 }
 
@@ -50,6 +72,14 @@ void df::Sound::pause() {
 	m_sound.pause();
 }
 
+void df::Sound::setLoaded(bool loaded) {
+	m_loaded = loaded;
+}
+
+bool df::Sound::getLoaded() const {
+	return m_loaded;
+}
+
 sf::Sound* df::Sound::getSound() const {
 	return (sf::Sound*)&m_sound;
 }
\ No newline at end of file
@@ -19,6 +19,7 @@ namespace df {
 		sf::Sound m_sound;	          // SFML sound.
 		sf::SoundBuffer m_sound_buffer; // SFML sound buffer associated with sound.
 		std::string m_label;	          // Text label to identify sound.
+		bool m_loaded;                  // True if sound buffer is ready to play.
 
 	public:
 
@@ -32,6 +33,14 @@ namespace df {
 		// Return 0 if ok, else -1.
 		int loadSound(std::string filename);
 
+		// Load sound buffer from encoded file contents in memory (decoded and copied).
+		// Return 0 if ok, else -1.
+		int loadSoundFromMemory(const void* p_data, size_t size);
+
+		// Load sound buffer from already decoded 16-bit samples (copied).
+		// Return 0 if ok, else -1.
+		int loadSoundFromSamples(const sf::Int16* p_samples, sf::Uint64 sample_count, unsigned int channel_count, unsigned int sample_rate);
+
 		// Set label associated with sound.
 		void setLabel(std::string new_label);
 
@@ -48,6 +57,12 @@ namespace df {
 		// Pause sound.
 		void pause();
 
+		// Set whether sound buffer is loaded.
+		void setLoaded(bool loaded = true);
+
+		// Return true if sound buffer is loaded.
+		bool getLoaded() const;
+
 		// Return SFML sound.
 		sf::Sound* getSound() const;
 	};
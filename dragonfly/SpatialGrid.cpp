@@ -0,0 +1,105 @@
+/**
+	Uniform spatial hash grid.
+	@file SpatialGrid.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "SpatialGrid.h"
+
+// Engine includes.
+#include "Object.h"
+#include "utility.h"
+
+df::SpatialGrid::SpatialGrid(float cell_size) {
+	m_cell_size = cell_size > 0 ? cell_size : df::GRID_CELL_SIZE_DEFAULT;
+}
+
+int64_t df::SpatialGrid::key(int x, int y) {
+	return ((int64_t)x << 32) | (uint32_t)y;
+}
+
+df::SpatialGrid::CellRange df::SpatialGrid::cellsOf(const df::Aabb& box) const {
+	CellRange range;
+	range.x0 = (int)floor(box.min_x / m_cell_size);
+	range.y0 = (int)floor(box.min_y / m_cell_size);
+	range.x1 = (int)floor(box.max_x / m_cell_size);
+	range.y1 = (int)floor(box.max_y / m_cell_size);
+	return range;
+}
+
+void df::SpatialGrid::addToCells(df::Object* p_o, const CellRange& range) {
+	Entry entry = { p_o, range };
+	for (int y = range.y0; y <= range.y1; y++) {
+		for (int x = range.x0; x <= range.x1; x++) {
+			m_cells[key(x, y)].push_back(entry);
+		}
+	}
+}
+
+void df::SpatialGrid::removeFromCells(const df::Object* p_o, const CellRange& range) {
+	for (int y = range.y0; y <= range.y1; y++) {
+		for (int x = range.x0; x <= range.x1; x++) {
+			std::unordered_map<int64_t, std::vector<Entry>>::iterator cell = m_cells.find(key(x, y));
+			if (cell == m_cells.end()) {
+				continue;
+			}
+			std::vector<Entry>& entries = cell->second;
+			for (size_t i = 0; i < entries.size(); i++) {
+				if (entries[i].p_o == p_o) {
+					entries[i] = entries.back();
+					entries.pop_back();
+					break;
+				}
+			}
+			if (entries.empty()) {
+				m_cells.erase(cell);
+			}
+		}
+	}
+}
+
+void df::SpatialGrid::insert(df::Object* p_o) {
+	if (contains(p_o)) {
+		return;
+	}
+	CellRange range = cellsOf(p_o->getWorldAabb());
+	m_ranges[p_o] = range;
+	addToCells(p_o, range);
+}
+
+void df::SpatialGrid::remove(const df::Object* p_o) {
+	std::unordered_map<const df::Object*, CellRange>::iterator it = m_ranges.find(p_o);
+	if (it == m_ranges.end()) {
+		return;
+	}
+	removeFromCells(p_o, it->second);
+	m_ranges.erase(it);
+}
+
+void df::SpatialGrid::update(df::Object* p_o) {
+	std::unordered_map<const df::Object*, CellRange>::iterator it = m_ranges.find(p_o);
+	if (it == m_ranges.end()) {
+		return;
+	}
+	CellRange range = cellsOf(p_o->getWorldAabb());
+	CellRange& old = it->second;
+	if (range.x0 == old.x0 && range.y0 == old.y0 && range.x1 == old.x1 && range.y1 == old.y1) {
+		return; // Still in the same cells (the common case).
+	}
+	removeFromCells(p_o, old);
+	old = range;
+	addToCells(p_o, range);
+}
+
+bool df::SpatialGrid::contains(const df::Object* p_o) const {
+	return m_ranges.find(p_o) != m_ranges.end();
+}
+
+void df::SpatialGrid::clear() {
+	m_cells.clear();
+	m_ranges.clear();
+}
+
+float df::SpatialGrid::getCellSize() const {
+	return m_cell_size;
+}
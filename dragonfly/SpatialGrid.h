@@ -0,0 +1,125 @@
+/**
+	@file SpatialGrid.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __SPATIAL_GRID_H__
+#define __SPATIAL_GRID_H__
+
+// System includes.
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Engine includes.
+#include "Aabb.h"
+#include "Box.h"
+
+namespace df {
+
+	class Object;
+
+	// Default size of a grid cell (spaces).
+	const float GRID_CELL_SIZE_DEFAULT = 8;
+
+	// Uniform grid over the world, hashing Objects into every cell their world box touches.
+	// Cells are only allocated where there are Objects, so the world can be any size.
+	class SpatialGrid {
+
+	private:
+		// Inclusive range of cells.
+		struct CellRange {
+			int x0, y0, x1, y1;
+		};
+
+		// Object stored in a cell, with the cells it covers (to report it once per query).
+		struct Entry {
+			Object* p_o;
+			CellRange range;
+		};
+
+		float m_cell_size;                                        // Size of a cell (spaces).
+		std::unordered_map<int64_t, std::vector<Entry>> m_cells;  // Occupied cells by key.
+		std::unordered_map<const Object*, CellRange> m_ranges;    // Cells each Object is in.
+
+		// Return key for cell (x, y).
+		static int64_t key(int x, int y);
+
+		// Return cells covered by box.
+		CellRange cellsOf(const Aabb& box) const;
+
+		void addToCells(Object* p_o, const CellRange& range);
+		void removeFromCells(const Object* p_o, const CellRange& range);
+
+		// Call visit(const Entry&) once for each Object in a cell touched by box.
+		template <typename F>
+		void forEachNearEntry(const Aabb& box, F visit) const {
+			CellRange query = cellsOf(box);
+			for (int y = query.y0; y <= query.y1; y++) {
+				for (int x = query.x0; x <= query.x1; x++) {
+					std::unordered_map<int64_t, std::vector<Entry>>::const_iterator cell = m_cells.find(key(x, y));
+					if (cell == m_cells.end()) {
+						continue;
+					}
+					for (size_t i = 0; i < cell->second.size(); i++) {
+						const Entry& entry = cell->second[i];
+						// Only report from the first cell shared with the query.
+						int first_x = entry.range.x0 > query.x0 ? entry.range.x0 : query.x0;
+						int first_y = entry.range.y0 > query.y0 ? entry.range.y0 : query.y0;
+						if (x == first_x && y == first_y) {
+							visit(entry);
+						}
+					}
+				}
+			}
+		}
+	public:
+		SpatialGrid(float cell_size = GRID_CELL_SIZE_DEFAULT);
+
+		// Add Object at its current world box (Object::getWorldAabb()). Does nothing if already added.
+		void insert(Object* p_o);
+
+		// Remove Object. Does nothing if not added.
+		void remove(const Object* p_o);
+
+		// Move Object to the cells of its current world box. Does nothing if not added.
+		void update(Object* p_o);
+
+		// Return true if Object has been added.
+		bool contains(const Object* p_o) const;
+
+		// Remove all Objects.
+		void clear();
+
+		// Return size of a cell (spaces).
+		float getCellSize() const;
+
+		// Call visit(Object*) once for each Object in a cell touched by box.
+		// Objects may be outside box itself; callers do the exact test.
+		template <typename F>
+		void forEachNear(const Aabb& box, F visit) const {
+			forEachNearEntry(box, [&](const Entry& entry) {
+				visit(entry.p_o);
+			});
+		}
+		template <typename F>
+		void forEachNear(const Box& box, F visit) const {
+			forEachNear(toAabb(box), visit);
+		}
+
+		// Call visit(Object*, bool inner) once for each Object in a cell touched by outer.
+		// inner is true if the Object is also in a cell touched by inner_box (a cell test, not a box test).
+		template <typename F>
+		void forEachNearTiered(const Aabb& inner_box, const Aabb& outer, F visit) const {
+			CellRange inner_cells = cellsOf(inner_box);
+			forEachNearEntry(outer, [&](const Entry& entry) {
+				visit(entry.p_o, entry.range.x0 <= inner_cells.x1 && entry.range.x1 >= inner_cells.x0 &&
+					entry.range.y0 <= inner_cells.y1 && entry.range.y1 >= inner_cells.y0);
+			});
+		}
+	};
+
+} // end of namespace df
+#endif // __SPATIAL_GRID_H__
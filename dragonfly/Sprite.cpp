@@ -18,15 +18,14 @@ df::Sprite::Sprite(int max_frames) {
 	m_max_frame_count = max_frames;
 	m_frame_count = 0;
 	m_color = df::COLOR_DEFAULT;
-	m_frame = new Frame[max_frames];
+	m_slowdown = 1;
+	m_glyphs = NULL;
+	m_frame_offset.reserve(max_frames > 0 ? max_frames : 0);
 	m_label = "";
 	m_transparent = '\0';
 }
 
 df::Sprite::~Sprite() {
-	if (!m_frame) {
-		delete[] m_frame;
-	}
 }
 
 void df::Sprite::setWidth(int new_width) {
@@ -62,17 +61,48 @@ int df::Sprite::addFrame(df::Frame new_frame) {
 		writeLog("ERROR", "Error adding frame. Frame array full.");
 		return -1;
 	}
-	*(m_frame + m_frame_count) = new_frame;
+	if (m_glyphs && m_glyphs != m_storage.data()) {
+		writeLog("ERROR", "Error adding frame. Frames set from external glyphs.");
+		return -1;
+	}
+	std::string frame_str = new_frame.getString();
+	frame_str.resize((size_t)m_width * m_height, ' ');
+	m_frame_offset.push_back((unsigned int)m_storage.size());
+	m_storage.insert(m_storage.end(), frame_str.begin(), frame_str.end());
+	m_glyphs = m_storage.data();
 	m_frame_count++;
 	return 0;
 }
 
 df::Frame df::Sprite::getFrame(int frame_number) const {
-	if (frame_number < 0 || frame_number >= m_frame_count) {
+	const char* p_glyphs = getGlyphs(frame_number);
+	if (!p_glyphs) {
 		df::Frame f;
 		return f;
 	}
-	return *(m_frame + frame_number);
+	return df::Frame(m_width, m_height, std::string(p_glyphs, (size_t)m_width * m_height), m_transparent);
+}
+
+int df::Sprite::setFrames(const char* p_glyphs, const std::vector<unsigned int>& frame_offset) {
+	if ((int)frame_offset.size() > m_max_frame_count) {
+		writeLog("ERROR", "Error setting frames. %d frames given for %d.", (int)frame_offset.size(), m_max_frame_count);
+		return -1;
+	}
+	m_glyphs = p_glyphs;
+	m_frame_offset = frame_offset;
+	m_frame_count = (int)frame_offset.size();
+	return 0;
+}
+
+void df::Sprite::holdStorage(std::vector<char>* p_storage) {
+	m_storage.swap(*p_storage);
+}
+
+const char* df::Sprite::getGlyphs(int frame_number) const {
+	if (frame_number < 0 || frame_number >= m_frame_count) {
+		return NULL;
+	}
+	return m_glyphs + m_frame_offset[frame_number];
 }
 
 void df::Sprite::setLabel(std::string new_label) {
@@ -100,7 +130,12 @@ char df::Sprite::getTransparent() const {
 }
 
 int df::Sprite::draw(int frame_number, df::Vector position) const {
-	if (m_frame[frame_number].draw(position, getColor(), getTransparent()) == -1) {
+	const char* p_glyphs = getGlyphs(frame_number);
+	if (!p_glyphs) {
+		writeLog("ERROR", "Error drawing sprite frame %d. Frame out of range.", frame_number);
+		return -1;
+	}
+	if (df::drawGlyphs(p_glyphs, m_width, m_height, position, getColor(), getTransparent()) == -1) {
 		writeLog("ERROR", "Error drawing sprite frame %d", frame_number);
 	}
 	return 0;
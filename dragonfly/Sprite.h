@@ -10,6 +10,9 @@
 // Engine includes.
 #include "Frame.h"
 
+// System includes.
+#include <vector>
+
 namespace df {
 
 	class Sprite {
@@ -21,7 +24,9 @@ namespace df {
 		int m_frame_count;      // Actual number of frames sprite has.
 		Color m_color;	  // Optional color for entire sprite.
 		int m_slowdown;        /// Animation slowdown (1 = no slowdown, 0 = stop).
-		Frame* m_frame;         // Array of frames.
+		const char* m_glyphs;   // Glyph block holding all frames (into m_storage or memory owned elsewhere).
+		std::vector<unsigned int> m_frame_offset; // Start of each frame in the glyph block.
+		std::vector<char> m_storage; // Memory owned by the sprite that m_glyphs may point into.
 		std::string m_label;	  // Text label to identify sprite.
 		char m_transparent;	     // Char used to indicate a transparent char.
 		Sprite();               // Sprite constructor always has one arg.
@@ -62,8 +67,23 @@ namespace df {
 
 		// Get next sprite frame indicated by number.
 		// Return empty frame if out of range [0, frame_count].
+		// Copies the frame characters. Use getGlyphs() to read them in place.
 		Frame getFrame(int frame_number) const;
 
+		// Use an existing glyph block for all frames instead of adding them one by one.
+		// Frame i is width * height characters starting at p_glyphs + frame_offset[i].
+		// p_glyphs is not copied and must outlive the sprite (see holdStorage()).
+		// Return 0 if ok, else -1.
+		int setFrames(const char* p_glyphs, const std::vector<unsigned int>& frame_offset);
+
+		// Take ownership of the memory that glyphs passed to setFrames() point into.
+		// Contents of p_storage are swapped in, so pointers into it stay valid.
+		void holdStorage(std::vector<char>* p_storage);
+
+		// Get characters of indicated frame (width * height, row major).
+		// Return NULL if out of range [0, frame_count].
+		const char* getGlyphs(int frame_number) const;
+
 		// Set label associated with sprite.
 		void setLabel(std::string new_label);
 
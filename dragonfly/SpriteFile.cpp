@@ -0,0 +1,249 @@
+/**
+	Text and compiled sprite file formats.
+	@file SpriteFile.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "SpriteFile.h"
+
+// System includes.
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+	// Walks a buffer one line at a time without copying.
+	class LineReader {
+	private:
+		const char* p_cur;
+		const char* p_end;
+	public:
+		LineReader(const char* p_data, size_t size) : p_cur(p_data), p_end(p_data + size) {}
+
+		// Get next line (without "\r\n") into p_line/p_length.
+		// Return false if no lines left.
+		bool next(const char** p_line, size_t* p_length) {
+			if (p_cur >= p_end) {
+				return false;
+			}
+			const char* p_eol = (const char*)memchr(p_cur, '\n', p_end - p_cur);
+			if (!p_eol) {
+				p_eol = p_end;
+			}
+			*p_line = p_cur;
+			*p_length = p_eol - p_cur;
+			if (*p_length > 0 && p_cur[*p_length - 1] == '\r') {
+				(*p_length)--;
+			}
+			p_cur = p_eol < p_end ? p_eol + 1 : p_end;
+			return true;
+		}
+	};
+
+	bool lineIs(const char* p_line, size_t length, const char* token) {
+		return length == strlen(token) && memcmp(p_line, token, length) == 0;
+	}
+
+	// Match "token value". Return true and set value if line starts with token.
+	bool matchToken(const char* p_line, size_t length, const char* token, std::string* p_value) {
+		size_t token_length = strlen(token);
+		if (length < token_length || memcmp(p_line, token, token_length) != 0) {
+			return false;
+		}
+		*p_value = length > token_length + 1 ? std::string(p_line + token_length + 1, length - token_length - 1) : "";
+		return true;
+	}
+
+	void writeUint32(std::vector<char>* p_out, size_t at, uint32_t value) {
+		memcpy(p_out->data() + at, &value, sizeof(value));
+	}
+}
+
+df::SpriteData::SpriteData() {
+	width = 0;
+	height = 0;
+	frame_count = 0;
+	slowdown = 1;
+	color = df::COLOR_DEFAULT;
+	transparent = '\0';
+}
+
+bool df::isSpriteBinary(const char* p_data, size_t size) {
+	return size >= sizeof(df::SPRITE_FILE_MAGIC) && memcmp(p_data, df::SPRITE_FILE_MAGIC, sizeof(df::SPRITE_FILE_MAGIC)) == 0;
+}
+
+int df::parseSpriteText(const char* p_data, size_t size, df::SpriteData* p_sprite, std::string* p_error) {
+	LineReader reader(p_data, size);
+	const char* p_line = NULL;
+	size_t length = 0;
+	if (!reader.next(&p_line, &length) || !lineIs(p_line, length, "<" HEADER_TOKEN ">")) {
+		*p_error = "HEADER not defined.";
+		return -1;
+	}
+	p_sprite->frame_count = -1;
+	p_sprite->width = -1;
+	p_sprite->height = -1;
+	std::string value;
+	bool closed = false;
+	while (reader.next(&p_line, &length)) {
+		if (lineIs(p_line, length, "</" HEADER_TOKEN ">")) {
+			closed = true;
+			break;
+		}
+		if (matchToken(p_line, length, FRAMES_TOKEN, &value)) {
+			p_sprite->frame_count = atoi(value.c_str());
+		}
+		else if (matchToken(p_line, length, WIDTH_TOKEN, &value)) {
+			p_sprite->width = atoi(value.c_str());
+		}
+		else if (matchToken(p_line, length, HEIGHT_TOKEN, &value)) {
+			p_sprite->height = atoi(value.c_str());
+		}
+		else if (matchToken(p_line, length, COLOR_TOKEN, &value)) {
+			p_sprite->color = df::colorFromName(value);
+		}
+		else if (matchToken(p_line, length, TRANSPARENT_TOKEN, &value)) {
+			p_sprite->transparent = value.empty() ? '\0' : value[0];
+		}
+		else if (matchToken(p_line, length, SLOWDOWN_TOKEN, &value)) {
+			p_sprite->slowdown = atoi(value.c_str());
+		}
+	}
+	if (!closed) {
+		*p_error = "HEADER not closed.";
+		return -1;
+	}
+	if (p_sprite->frame_count < 0) {
+		*p_error = FRAMES_TOKEN " not declared in " HEADER_TOKEN ".";
+		return -1;
+	}
+	if (p_sprite->width < 0) {
+		*p_error = WIDTH_TOKEN " not declared in " HEADER_TOKEN ".";
+		return -1;
+	}
+	if (p_sprite->height < 0) {
+		*p_error = HEIGHT_TOKEN " not declared in " HEADER_TOKEN ".";
+		return -1;
+	}
+	if (!reader.next(&p_line, &length) || !lineIs(p_line, length, "<" BODY_TOKEN ">")) {
+		*p_error = "BODY not defined.";
+		return -1;
+	}
+	const size_t frame_size = (size_t)p_sprite->width * p_sprite->height;
+	p_sprite->glyphs.clear();
+	p_sprite->glyphs.reserve(frame_size * p_sprite->frame_count);
+	p_sprite->frame_offset.clear();
+	p_sprite->frame_offset.reserve(p_sprite->frame_count);
+	for (int i = 0; i < p_sprite->frame_count; i++) {
+		p_sprite->frame_offset.push_back((uint32_t)p_sprite->glyphs.size());
+		for (int y = 0; y < p_sprite->height; y++) {
+			if (!reader.next(&p_line, &length) || length != (size_t)p_sprite->width || lineIs(p_line, length, "</" BODY_TOKEN ">")) {
+				*p_error = "frame " + std::to_string(i) + " not declared properly in BODY.";
+				return -1;
+			}
+			p_sprite->glyphs.insert(p_sprite->glyphs.end(), p_line, p_line + length);
+		}
+		if (!reader.next(&p_line, &length) || !lineIs(p_line, length, END_FRAME_TOKEN)) {
+			*p_error = "frame " + std::to_string(i) + " not declared properly in BODY.";
+			return -1;
+		}
+	}
+	// Anything between the last frame and the end of the body is ignored, as is the footer.
+	while (reader.next(&p_line, &length)) {
+		if (lineIs(p_line, length, "</" BODY_TOKEN ">")) {
+			return 0;
+		}
+	}
+	*p_error = "BODY not closed.";
+	return -1;
+}
+
+void df::writeSpriteBinary(const df::SpriteData& sprite, std::vector<char>* p_out) {
+	df::SpriteFileHeader header;
+	memcpy(header.magic, df::SPRITE_FILE_MAGIC, sizeof(header.magic));
+	header.version = df::SPRITE_FILE_VERSION;
+	header.width = sprite.width;
+	header.height = sprite.height;
+	header.frame_count = (int32_t)sprite.frame_offset.size();
+	header.slowdown = sprite.slowdown;
+	header.color = (int32_t)sprite.color;
+	header.transparent = (unsigned char)sprite.transparent;
+	header.glyph_offset = (uint32_t)(sizeof(header) + sizeof(uint32_t) * sprite.frame_offset.size());
+	header.glyph_size = (uint32_t)sprite.glyphs.size();
+	p_out->assign(header.glyph_offset + header.glyph_size, 0);
+	memcpy(p_out->data(), &header, sizeof(header));
+	for (size_t i = 0; i < sprite.frame_offset.size(); i++) {
+		writeUint32(p_out, sizeof(header) + i * sizeof(uint32_t), sprite.frame_offset[i]);
+	}
+	if (!sprite.glyphs.empty()) {
+		memcpy(p_out->data() + header.glyph_offset, sprite.glyphs.data(), sprite.glyphs.size());
+	}
+}
+
+int df::readSpriteBinary(const char* p_data, size_t size, df::SpriteFileHeader* p_header, std::vector<uint32_t>* p_frame_offset, const char** p_glyphs, std::string* p_error) {
+	if (size < sizeof(df::SpriteFileHeader) || !df::isSpriteBinary(p_data, size)) {
+		*p_error = "not a compiled sprite.";
+		return -1;
+	}
+	memcpy(p_header, p_data, sizeof(df::SpriteFileHeader));
+	if (p_header->version != df::SPRITE_FILE_VERSION) {
+		*p_error = "unsupported compiled sprite version " + std::to_string(p_header->version) + ".";
+		return -1;
+	}
+	if (p_header->width < 0 || p_header->height < 0 || p_header->frame_count < 0) {
+		*p_error = "bad dimensions.";
+		return -1;
+	}
+	const uint64_t table_end = sizeof(df::SpriteFileHeader) + (uint64_t)sizeof(uint32_t) * p_header->frame_count;
+	if (table_end > p_header->glyph_offset || (uint64_t)p_header->glyph_offset + p_header->glyph_size > size) {
+		*p_error = "truncated file.";
+		return -1;
+	}
+	const uint64_t frame_size = (uint64_t)p_header->width * p_header->height;
+	p_frame_offset->resize(p_header->frame_count);
+	for (int i = 0; i < p_header->frame_count; i++) {
+		uint32_t offset;
+		memcpy(&offset, p_data + sizeof(df::SpriteFileHeader) + i * sizeof(uint32_t), sizeof(offset));
+		if (offset + frame_size > p_header->glyph_size) {
+			*p_error = "frame " + std::to_string(i) + " out of range.";
+			return -1;
+		}
+		(*p_frame_offset)[i] = offset;
+	}
+	*p_glyphs = p_data + p_header->glyph_offset;
+	return 0;
+}
+
+df::Color df::colorFromName(const std::string& name) {
+	if (name == "black") {
+		return df::Color::BLACK;
+	}
+	else if (name == "red") {
+		return df::Color::RED;
+	}
+	else if (name == "green") {
+		return df::Color::GREEN;
+	}
+	else if (name == "yellow") {
+		return df::Color::YELLOW;
+	}
+	else if (name == "blue") {
+		return df::Color::BLUE;
+	}
+	else if (name == "magenta") {
+		return df::Color::MAGENTA;
+	}
+	else if (name == "cyan") {
+		return df::Color::CYAN;
+	}
+	else if (name == "white") {
+		return df::Color::WHITE;
+	}
+	else if (name == "orange") {
+		return df::Color::ORANGE;
+	}
+	else if (name == "custom") {
+		return df::Color::CUSTOM;
+	}
+	return df::COLOR_DEFAULT;
+}
@@ -0,0 +1,89 @@
+/**
+	@file SpriteFile.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __SPRITE_FILE_H__
+#define __SPRITE_FILE_H__
+
+// Engine includes.
+#include "Color.h"
+
+// System includes.
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Delimiters used to parse text Sprite files
+#define HEADER_TOKEN "HEADER"
+#define BODY_TOKEN "BODY"
+#define FOOTER_TOKEN "FOOTER"
+#define FRAMES_TOKEN "frames"
+#define HEIGHT_TOKEN "height"
+#define WIDTH_TOKEN "width"
+#define COLOR_TOKEN "color"
+#define TRANSPARENT_TOKEN "transparent"
+#define SLOWDOWN_TOKEN "slowdown"
+#define END_FRAME_TOKEN "end"
+#define VERSION_TOKEN "version"
+
+namespace df {
+
+	// Magic bytes at the start of a compiled sprite file.
+	const char SPRITE_FILE_MAGIC[4] = { 'D', 'F', 'S', 'P' };
+
+	// Compiled sprite file version. Bump when the layout changes.
+	const uint32_t SPRITE_FILE_VERSION = 1;
+
+	// Header of a compiled sprite file. Stored little endian.
+	// Followed by frame_count frame offsets (uint32, relative to the glyph block) and then the glyph block.
+	// Each frame is width * height glyphs, row major.
+	struct SpriteFileHeader {
+		char magic[4];         // SPRITE_FILE_MAGIC.
+		uint32_t version;      // SPRITE_FILE_VERSION.
+		int32_t width;         // Frame width.
+		int32_t height;        // Frame height.
+		int32_t frame_count;   // Number of frames.
+		int32_t slowdown;      // Animation slowdown.
+		int32_t color;         // df::Color of the sprite.
+		int32_t transparent;   // Transparent char (0 if none).
+		uint32_t glyph_offset; // Start of the glyph block from the start of the file.
+		uint32_t glyph_size;   // Size of the glyph block in bytes.
+	};
+
+	// Sprite contents parsed from a text sprite.
+	struct SpriteData {
+		int width;
+		int height;
+		int frame_count;
+		int slowdown;
+		Color color;
+		char transparent;
+		std::vector<uint32_t> frame_offset; // Start of each frame in glyphs.
+		std::vector<char> glyphs;           // All frames back to back.
+
+		SpriteData();
+	};
+
+	// Return true if the file contents start with the compiled sprite magic.
+	bool isSpriteBinary(const char* p_data, size_t size);
+
+	// Parse text sprite (<HEADER>/<BODY> format) in one pass.
+	// Return 0 if ok, else -1 with reason in p_error.
+	int parseSpriteText(const char* p_data, size_t size, SpriteData* p_sprite, std::string* p_error);
+
+	// Write sprite in compiled format to p_out (replacing contents).
+	void writeSpriteBinary(const SpriteData& sprite, std::vector<char>* p_out);
+
+	// Validate compiled sprite in place.
+	// Fill header, frame offsets and pointer to glyph block inside p_data (nothing is copied).
+	// Return 0 if ok, else -1 with reason in p_error.
+	int readSpriteBinary(const char* p_data, size_t size, SpriteFileHeader* p_header, std::vector<uint32_t>* p_frame_offset, const char** p_glyphs, std::string* p_error);
+
+	// Return Color for a sprite file color name (e.g., "green"). COLOR_DEFAULT if not recognized.
+	Color colorFromName(const std::string& name);
+
+} // end of namespace df
+#endif // __SPRITE_FILE_H__
@@ -0,0 +1,238 @@
+/**
+	Structure of arrays store for Object transforms.
+	@file TransformStore.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "TransformStore.h"
+
+// System includes.
+#include <utility>
+
+// Engine includes.
+#include "Object.h"
+
+df::TransformStore::TransformStore() {
+	m_moving_count = 0;
+	m_reduced_rate = 1;
+}
+
+int df::TransformStore::allocate(df::Object* p_o) {
+	int slot = (int)m_owner.size();
+	m_x.push_back(0);
+	m_y.push_back(0);
+	m_velocity_x.push_back(0);
+	m_velocity_y.push_back(0);
+	m_box_x.push_back(0);
+	m_box_y.push_back(0);
+	m_box_w.push_back(0);
+	m_box_h.push_back(0);
+	m_gravity.push_back(0);
+	m_damping.push_back(1);
+	m_damping_reduced.push_back(1);
+	m_steps.push_back(0);
+	Aabb empty = { 0, 0, 0, 0 };
+	m_world_box.push_back(empty);
+	m_owner.push_back(p_o);
+	return slot;
+}
+
+void df::TransformStore::release(int slot) {
+	if (slot < m_moving_count) {
+		setMoving(slot, false);
+		slot = m_moving_count;
+	}
+	size_t last = m_owner.size() - 1;
+	if ((size_t)slot != last) {
+		m_x[slot] = m_x[last];
+		m_y[slot] = m_y[last];
+		m_velocity_x[slot] = m_velocity_x[last];
+		m_velocity_y[slot] = m_velocity_y[last];
+		m_box_x[slot] = m_box_x[last];
+		m_box_y[slot] = m_box_y[last];
+		m_box_w[slot] = m_box_w[last];
+		m_box_h[slot] = m_box_h[last];
+		m_gravity[slot] = m_gravity[last];
+		m_damping[slot] = m_damping[last];
+		m_damping_reduced[slot] = m_damping_reduced[last];
+		m_steps[slot] = m_steps[last];
+		m_world_box[slot] = m_world_box[last];
+		m_owner[slot] = m_owner[last];
+		m_owner[slot]->m_slot = slot;
+	}
+	m_x.pop_back();
+	m_y.pop_back();
+	m_velocity_x.pop_back();
+	m_velocity_y.pop_back();
+	m_box_x.pop_back();
+	m_box_y.pop_back();
+	m_box_w.pop_back();
+	m_box_h.pop_back();
+	m_gravity.pop_back();
+	m_damping.pop_back();
+	m_damping_reduced.pop_back();
+	m_steps.pop_back();
+	m_world_box.pop_back();
+	m_owner.pop_back();
+}
+
+void df::TransformStore::reserve(int count) {
+	m_x.reserve(count);
+	m_y.reserve(count);
+	m_velocity_x.reserve(count);
+	m_velocity_y.reserve(count);
+	m_box_x.reserve(count);
+	m_box_y.reserve(count);
+	m_box_w.reserve(count);
+	m_box_h.reserve(count);
+	m_gravity.reserve(count);
+	m_damping.reserve(count);
+	m_damping_reduced.reserve(count);
+	m_steps.reserve(count);
+	m_world_box.reserve(count);
+	m_owner.reserve(count);
+}
+
+int df::TransformStore::getCount() const {
+	return (int)m_owner.size();
+}
+
+df::Vector df::TransformStore::getPosition(int slot) const {
+	return df::Vector(m_x[slot], m_y[slot]);
+}
+
+void df::TransformStore::setPosition(int slot, df::Vector position) {
+	m_x[slot] = position.getX();
+	m_y[slot] = position.getY();
+	updateWorldBox(slot);
+}
+
+df::Vector df::TransformStore::getVelocity(int slot) const {
+	return df::Vector(m_velocity_x[slot], m_velocity_y[slot]);
+}
+
+void df::TransformStore::setVelocity(int slot, df::Vector velocity) {
+	m_velocity_x[slot] = velocity.getX();
+	m_velocity_y[slot] = velocity.getY();
+}
+
+df::Box df::TransformStore::getBox(int slot) const {
+	return df::Box(df::Vector(m_box_x[slot], m_box_y[slot]), m_box_w[slot], m_box_h[slot]);
+}
+
+void df::TransformStore::setBox(int slot, df::Box box) {
+	m_box_x[slot] = box.getCorner().getX();
+	m_box_y[slot] = box.getCorner().getY();
+	m_box_w[slot] = box.getHorizontal();
+	m_box_h[slot] = box.getVertical();
+	updateWorldBox(slot);
+}
+
+df::Aabb df::TransformStore::getWorldBox(int slot) const {
+	return m_world_box[slot];
+}
+
+void df::TransformStore::updateWorldBox(int slot) {
+	Aabb& world_box = m_world_box[slot];
+	world_box.min_x = m_x[slot] + m_box_x[slot];
+	world_box.min_y = m_y[slot] + m_box_y[slot];
+	world_box.max_x = world_box.min_x + m_box_w[slot];
+	world_box.max_y = world_box.min_y + m_box_h[slot];
+}
+
+bool df::TransformStore::hasGravity(int slot) const {
+	return m_gravity[slot] != 0;
+}
+
+void df::TransformStore::setGravity(int slot, bool gravity) {
+	m_gravity[slot] = gravity ? 1.0f : 0.0f;
+}
+
+float df::TransformStore::getDamping(int slot) const {
+	return m_damping[slot];
+}
+
+void df::TransformStore::setDamping(int slot, float damping) {
+	m_damping[slot] = damping;
+	m_damping_reduced[slot] = reduceDamping(damping);
+}
+
+float df::TransformStore::reduceDamping(float damping) const {
+	// The rate is a small integer, so multiply rather than call pow().
+	float keep = 1;
+	for (int i = 0; i < m_reduced_rate; i++) {
+		keep *= damping;
+	}
+	return keep;
+}
+
+void df::TransformStore::swapSlots(int a, int b) {
+	if (a == b) {
+		return;
+	}
+	std::swap(m_x[a], m_x[b]);
+	std::swap(m_y[a], m_y[b]);
+	std::swap(m_velocity_x[a], m_velocity_x[b]);
+	std::swap(m_velocity_y[a], m_velocity_y[b]);
+	std::swap(m_box_x[a], m_box_x[b]);
+	std::swap(m_box_y[a], m_box_y[b]);
+	std::swap(m_box_w[a], m_box_w[b]);
+	std::swap(m_box_h[a], m_box_h[b]);
+	std::swap(m_gravity[a], m_gravity[b]);
+	std::swap(m_damping[a], m_damping[b]);
+	std::swap(m_damping_reduced[a], m_damping_reduced[b]);
+	std::swap(m_steps[a], m_steps[b]);
+	std::swap(m_world_box[a], m_world_box[b]);
+	std::swap(m_owner[a], m_owner[b]);
+	m_owner[a]->m_slot = a;
+	m_owner[b]->m_slot = b;
+}
+
+void df::TransformStore::setMoving(int slot, bool moving) {
+	if (moving == isMoving(slot)) {
+		return;
+	}
+	if (moving) {
+		swapSlots(slot, m_moving_count);
+		m_moving_count++;
+	}
+	else {
+		m_moving_count--;
+		m_steps[slot] = 0;
+		swapSlots(slot, m_moving_count);
+	}
+}
+
+bool df::TransformStore::isMoving(int slot) const {
+	return slot < m_moving_count;
+}
+
+void df::TransformStore::setSteps(int slot, int steps) {
+	m_steps[slot] = (float)steps;
+}
+
+void df::TransformStore::setReducedRate(int rate) {
+	m_reduced_rate = rate;
+	for (size_t i = 0; i < m_damping.size(); i++) {
+		m_damping_reduced[i] = reduceDamping(m_damping[i]);
+	}
+}
+
+void df::TransformStore::integrate(float gravity) {
+	// Plain float arrays, walked front to back over the moving slots.
+	float* p_vx = m_velocity_x.data();
+	float* p_vy = m_velocity_y.data();
+	float* p_steps = m_steps.data();
+	const float* p_gravity = m_gravity.data();
+	const float* p_damping = m_damping.data();
+	const float* p_damping_reduced = m_damping_reduced.data();
+	const int count = m_moving_count;
+	for (int slot = 0; slot < count; slot++) {
+		const float steps = p_steps[slot];
+		// Full tier slots keep one step's damping, reduced tier ones the precomputed rate's, the rest all of it.
+		const float keep = steps == 1 ? p_damping[slot] : (steps == 0 ? 1.0f : p_damping_reduced[slot]);
+		p_vx[slot] = p_vx[slot] * keep;
+		p_vy[slot] = (p_vy[slot] + gravity * p_gravity[slot] * steps) * keep;
+		p_steps[slot] = 0;
+	}
+}
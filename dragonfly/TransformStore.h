@@ -0,0 +1,103 @@
+/**
+	@file TransformStore.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __TRANSFORM_STORE_H__
+#define __TRANSFORM_STORE_H__
+
+// System includes.
+#include <cstdint>
+#include <vector>
+
+// Engine includes.
+#include "Aabb.h"
+#include "Box.h"
+#include "Vector.h"
+
+namespace df {
+
+	class Object;
+
+	// Position, velocity and box of every Object, one array per field (structure of arrays).
+	// Each Object owns one slot. Slots stay packed: freeing one moves the last slot into it.
+	// Moving slots are kept at the front, so integrate() is a straight pass over them.
+	class TransformStore {
+
+	private:
+		std::vector<float> m_x, m_y;             // Position.
+		std::vector<float> m_velocity_x, m_velocity_y; // Velocity (spaces per step).
+		std::vector<float> m_box_x, m_box_y;     // Box corner, relative to position.
+		std::vector<float> m_box_w, m_box_h;     // Box extents.
+		std::vector<float> m_gravity;            // 1 if affected by gravity, else 0.
+		std::vector<float> m_damping;            // Fraction of velocity kept each step.
+		std::vector<float> m_damping_reduced;    // Fraction kept over m_reduced_rate steps.
+		std::vector<float> m_steps;              // Steps the next integrate() stands for. 0 if not updated.
+		std::vector<Aabb> m_world_box;           // Box at position. Kept in step with position and box.
+		std::vector<Object*> m_owner;            // Object owning each slot.
+		int m_moving_count;                      // Slots [0, m_moving_count) are moving.
+		int m_reduced_rate;                      // Steps a reduced tier update stands for.
+		TransformStore(TransformStore const&);   // Don't allow copy.
+		void operator=(TransformStore const&);   // Don't allow assignment.
+
+		// Recompute world box after position or box changed.
+		void updateWorldBox(int slot);
+
+		// Return damping kept over m_reduced_rate steps.
+		float reduceDamping(float damping) const;
+
+		// Exchange two slots, telling their Objects.
+		void swapSlots(int a, int b);
+	public:
+		TransformStore();
+
+		// Add slot for Object, at the origin with no velocity, box or gravity.
+		// Return the slot.
+		int allocate(Object* p_o);
+
+		// Free slot. The last slot moves into it and its Object is told its new slot.
+		void release(int slot);
+
+		// Make room for count slots in total, so allocating up to count does not reallocate.
+		void reserve(int count);
+
+		// Return number of slots in use.
+		int getCount() const;
+
+		Vector getPosition(int slot) const;
+		void setPosition(int slot, Vector position);
+
+		Vector getVelocity(int slot) const;
+		void setVelocity(int slot, Vector velocity);
+
+		Box getBox(int slot) const;
+		void setBox(int slot, Box box);
+
+		// Return box at position, in world space.
+		Aabb getWorldBox(int slot) const;
+
+		bool hasGravity(int slot) const;
+		void setGravity(int slot, bool gravity);
+
+		float getDamping(int slot) const;
+		void setDamping(int slot, float damping);
+
+		// Move slot into or out of the moving slots at the front. The Object is told its new slot.
+		void setMoving(int slot, bool moving);
+		bool isMoving(int slot) const;
+
+		// Set steps the slot's next integrate() stands for: 1 or the reduced rate. Slot must be moving.
+		void setSteps(int slot, int steps);
+
+		// Set steps a reduced tier update stands for.
+		void setReducedRate(int rate);
+
+		// Add gravity to and damp the velocity of the moving slots, in one pass.
+		// Slots without steps set since the last pass are left as they are.
+		// Still Objects are not visited, so cost nothing.
+		void integrate(float gravity);
+	};
+
+} // end of namespace df
+#endif // __TRANSFORM_STORE_H__
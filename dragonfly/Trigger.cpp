@@ -0,0 +1,35 @@
+/**
+	Trigger volume.
+	@file Trigger.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+#include "Trigger.h"
+
+// Engine includes.
+#include "WorldManager.h"
+
+df::Trigger::Trigger() {
+	setType("Trigger");
+	setSolidness(df::Solidness::SPECTRAL);
+	m_filter_type = -1;
+	WM.getComponents().add(this, df::Component::TRIGGER);
+}
+
+df::Trigger::~Trigger() {
+}
+
+void df::Trigger::setFilterType(std::string type) {
+	m_filter_type = type.empty() ? -1 : df::intern(type);
+}
+
+df::StringId df::Trigger::getFilterType() const {
+	return m_filter_type;
+}
+
+bool df::Trigger::accepts(const df::Object* p_o) const {
+	if (p_o == this || !p_o->isActive() || p_o->isViewObject() || p_o->hasComponent(df::Component::TRIGGER)) {
+		return false;
+	}
+	return m_filter_type == -1 || p_o->getTypeId() == m_filter_type;
+}
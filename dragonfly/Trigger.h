@@ -0,0 +1,42 @@
+/**
+	@file Trigger.h
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+#pragma once
+
+#ifndef __TRIGGER_H__
+#define __TRIGGER_H__
+
+// Engine includes.
+#include "Object.h"
+
+namespace df {
+
+	// Region that fires trigger events (see EventTrigger) when Objects enter or leave its box.
+	// Spectral, so it never blocks and the movement solver never sees it. WorldManager tests
+	// triggers once per step, only against Objects that moved (or when the trigger itself moved).
+	// Both the trigger and the Object get the event.
+	class Trigger : public Object {
+
+	private:
+		StringId m_filter_type; // Only Objects of this type set it off (-1 for any).
+
+	public:
+		// Create trigger. Set position and box, then insert it with WM.insertObject().
+		Trigger();
+
+		// Destroy trigger. Objects inside it are not sent leave events.
+		virtual ~Trigger();
+
+		// Only Objects of type set trigger off ("" for any, the default).
+		void setFilterType(std::string type);
+
+		// Return interned type setting trigger off, else -1 for any.
+		StringId getFilterType() const;
+
+		// Return true if Object can set trigger off: active, not a view object or trigger, and of the filter type.
+		bool accepts(const Object* p_o) const;
+	};
+
+} // end of namespace df
+#endif // __TRIGGER_H__
@@ -59,6 +59,19 @@ int df::ViewObject::draw() {
 	return 0;
 }
 
+df::Box df::ViewObject::getScreenBox() const {
+	df::Vector pos = df::worldToView(getPosition());
+	float width = (float)(getViewString().length() + 1 + df::toString(m_value).length());
+	float height = 1;
+	if (m_border) {
+		// Same row offsets as draw().
+		width += 4; // "| " and " |"
+		height += 2 * (int)df::charHeight();
+		pos.setY(pos.getY() - (int)df::charHeight());
+	}
+	return df::Box(df::Vector(pos.getX() - width / 2, pos.getY()), width, height);
+}
+
 int df::ViewObject::eventHandler(const Event* p_e) {
 	if (p_e->getType() == VIEW_EVENT) {
 		const df::EventView* p_ve = static_cast<const df::EventView*>(p_e);
@@ -44,6 +44,9 @@ namespace df {
 		// Draw view string (and value).
 		virtual int draw();
 
+		// Return box covered on screen (in spaces, view coordinates), border included.
+		Box getScreenBox() const;
+
 		// Handle "view" event if tag matches view_string (others ignored).
 		// Return 0 if ignored, else 1.
 		virtual int eventHandler(const Event* p_e);
@@ -8,13 +8,19 @@
 
 // Engine includes.
 #include "DisplayManager.h"
+#include "GameManager.h"
+#include "InputManager.h"
+#include "JobManager.h"
 #include "LogManager.h"
 #include "EventCollision.h"
 #include "EventStep.h"
 #include "EventOut.h"
+#include "EventTrigger.h"
+#include "Trigger.h"
 #include "ViewObject.h"
 #include "utility.h"
 
+#include <algorithm>
 #include <unordered_set>
 
 df::WorldManager::WorldManager() {
@@ -28,10 +34,19 @@ df::WorldManager::WorldManager() {
 	}
 	boundary = df::Box(df::Vector() - ((w - v) / 2.0), w.getX(), w.getY());
 	view = df::Box(df::Vector(), v.getX(), v.getY());
-	p_view_following = NULL;
+	m_view_following = df::Handle();
 	view_slack = df::Vector();
-	m_deletions;
+	m_deletions.clear();
 	scene_graph = df::SceneGraph();
+	m_iterating = 0;
+	m_spawning = 0;
+	m_spawned = 0;
+	m_step_count = 0;
+	m_move_steps = 1;
+	m_full_tier_margin = df::FULL_TIER_MARGIN_DEFAULT;
+	m_reduced_tier_margin = df::REDUCED_TIER_MARGIN_DEFAULT;
+	m_reduced_tier_rate = df::REDUCED_TIER_RATE_DEFAULT;
+	m_transforms.setReducedRate(m_reduced_tier_rate);
 }
 
 df::WorldManager::WorldManager(WorldManager const&) {
@@ -39,10 +54,19 @@ df::WorldManager::WorldManager(WorldManager const&) {
 	df::Vector w(DM.getHorizontal(), DM.getVertical()), v = df::pixelsToSpaces(df::Vector(DM.getHorizontalPixels(), DM.getVerticalPixels()));
 	boundary = df::Box(df::Vector(), w.getX(), w.getY());
 	view = df::Box((w - v) / 2.0, v.getX(), v.getY());
-	p_view_following = NULL;
+	m_view_following = df::Handle();
 	view_slack = df::Vector();
-	m_deletions;
+	m_deletions.clear();
 	scene_graph = df::SceneGraph();
+	m_iterating = 0;
+	m_spawning = 0;
+	m_spawned = 0;
+	m_step_count = 0;
+	m_move_steps = 1;
+	m_full_tier_margin = df::FULL_TIER_MARGIN_DEFAULT;
+	m_reduced_tier_margin = df::REDUCED_TIER_MARGIN_DEFAULT;
+	m_reduced_tier_rate = df::REDUCED_TIER_RATE_DEFAULT;
+	m_transforms.setReducedRate(m_reduced_tier_rate);
 }
 
 void df::WorldManager::operator=(WorldManager const&) {
@@ -72,115 +96,654 @@ int df::WorldManager::startUp() {
 void df::WorldManager::shutDown() {
 	// Destroy all objects in the scene graph.
 	writeLog("", "Killing all Objects.");
-	df::ObjectList m_deletions = getAllObjects();
-	df::ObjectListIterator li(&m_deletions);
-	li.first();
-	while (!li.isDone() && li.currentObject()) {
-		delete li.currentObject();
-		li.next();
+	const df::ObjectList* lists[] = { &scene_graph.activeObjects(), &scene_graph.inactiveObjects() };
+	for (int i = 0; i < 2; i++) {
+		df::ObjectListIterator li(lists[i]);
+		for (li.first(); !li.isDone() && li.currentObject(); li.next()) {
+			markForDelete(li.currentObject());
+		}
 	}
-	m_deletions.clear();
-	// Clear object lists.
-	scene_graph.activeObjects().clear();
-	scene_graph.inactiveObjects().clear();
-	scene_graph.solidObjects().clear();
-	for (int i = 0; i < df::MAX_ALTITUDE + 1; i++) {
-		scene_graph.visibleObjects(i).clear();
+	while (!m_deletions.empty()) {
+		deleteMarked();
 	}
+	m_commands.clear();
+	m_contacts.clear();
+	m_moved.clear();
+	m_occupants.clear();
+	m_grid.clear();
+	// Clear object lists.
+	scene_graph.clear();
 	Manager::shutDown();
 }
 
 int df::WorldManager::insertObject(df::Object* p_o) {
-	return scene_graph.insertObject(p_o);
+	return record(p_o, Change::INSERT, 0);
 }
 
 int df::WorldManager::removeObject(df::Object* p_o) {
+	// Bring the SceneGraph up to date with p_o, so it is removed from the lists it is really in.
+	std::vector<Command> pending;
+	for (size_t i = 0; i < m_commands.size(); ) {
+		if (m_commands[i].p_object == p_o) {
+			pending.push_back(m_commands[i]);
+			m_commands.erase(m_commands.begin() + i);
+		}
+		else {
+			i++;
+		}
+	}
+	if (!pending.empty()) {
+		applyObjectCommands(pending, 0, pending.size());
+	}
+	m_grid.remove(p_o);
 	return scene_graph.removeObject(p_o);
 }
 
+void df::WorldManager::beginSpawnBatch(int expected) {
+	if (m_spawning == 0) {
+		m_spawned = 0;
+	}
+	m_spawning++;
+	beginIteration();
+	if (expected > 0) {
+		m_commands.reserve(m_commands.size() + expected * 2);
+		m_transforms.reserve(m_transforms.getCount() + expected);
+	}
+}
+
+int df::WorldManager::endSpawnBatch() {
+	if (m_spawning == 0) {
+		writeLog("ERROR", "endSpawnBatch() without beginSpawnBatch().");
+		return 0;
+	}
+	m_spawning--;
+	int count = 0;
+	if (m_spawning == 0) {
+		count = m_spawned;
+		m_spawned = 0;
+		writeLog("", "Spawned %d objects in one batch.", count);
+	}
+	endIteration();
+	return count;
+}
+
+bool df::WorldManager::addToSpawnBatch(df::Object* /*p_o*/) {
+	if (m_spawning == 0) {
+		return false;
+	}
+	m_spawned++;
+	return true;
+}
+
+bool df::WorldManager::isSpawning() const {
+	return m_spawning > 0;
+}
+
 df::ObjectList df::WorldManager::getAllObjects() const {
-	return scene_graph.activeObjects() + scene_graph.inactiveObjects();
+	df::ObjectList all = scene_graph.activeObjects();
+	return all + scene_graph.inactiveObjects();
 }
 
 df::ObjectList df::WorldManager::objectsOfType(std::string type) const {
-	df::ObjectList list, ol = scene_graph.activeObjects();
-	df::ObjectListIterator li(&ol);
-	li.first();
-	while (!li.isDone() && li.currentObject()) {
-		if (li.currentObject()->getType() == type) {
-			list.insert(li.currentObject());
+	df::ObjectList list;
+	const std::vector<df::Object*>& same_type = objectsOfType(df::intern(type));
+	for (size_t i = 0; i < same_type.size(); i++) {
+		if (same_type[i]->isActive()) {
+			list.insert(same_type[i]);
 		}
 	}
 	return list;
 }
 
+const std::vector<df::Object*>& df::WorldManager::objectsOfType(df::StringId type) const {
+	return scene_graph.objectsOfType(type);
+}
+
+df::Object* df::WorldManager::firstOfType(df::StringId type) const {
+	const std::vector<df::Object*>& same_type = objectsOfType(type);
+	for (size_t i = 0; i < same_type.size(); i++) {
+		if (same_type[i]->isActive()) {
+			return same_type[i];
+		}
+	}
+	return NULL;
+}
+
+int df::WorldManager::updateType(df::Object* p_o, df::StringId old_type) {
+	return record(p_o, Change::TYPE, old_type);
+}
+
+int df::WorldManager::updateAltitude(df::Object* p_o, int old_altitude) {
+	return record(p_o, Change::ALTITUDE, old_altitude);
+}
+
+int df::WorldManager::updateSolidness(df::Object* p_o, bool was_solid) {
+	return record(p_o, Change::SOLIDNESS, was_solid);
+}
+
+int df::WorldManager::updateActive(df::Object* p_o, bool was_active) {
+	return record(p_o, Change::ACTIVE, was_active);
+}
+
+int df::WorldManager::updateVisible(df::Object* p_o, bool was_visible) {
+	return record(p_o, Change::VISIBLE, was_visible);
+}
+
+void df::WorldManager::beginIteration() {
+	m_iterating++;
+}
+
+void df::WorldManager::endIteration() {
+	m_iterating--;
+	if (m_iterating == 0 && !m_commands.empty()) {
+		applyCommands();
+	}
+}
+
+int df::WorldManager::record(df::Object* p_o, Change change, int old_value) {
+	Command command = { p_o, p_o->getId(), change, old_value };
+	if (m_iterating > 0) {
+		m_commands.push_back(command);
+		return 0;
+	}
+	std::vector<Command> now(1, command);
+	return applyObjectCommands(now, 0, 1);
+}
+
+void df::WorldManager::applyCommands() {
+	// Applying runs no handlers, so nothing new is recorded meanwhile.
+	std::vector<Command> commands;
+	commands.swap(m_commands);
+	std::stable_sort(commands.begin(), commands.end(), [](const Command& a, const Command& b) {
+		return a.id < b.id;
+	});
+	std::vector<df::Object*> inserts;
+	size_t begin = 0;
+	while (begin < commands.size()) {
+		size_t end = begin + 1;
+		while (end < commands.size() && commands[end].p_object == commands[begin].p_object) {
+			end++;
+		}
+		applyObjectCommands(commands, begin, end, &inserts);
+		begin = end;
+	}
+	// New Objects go in together, one pass per index.
+	if (!inserts.empty()) {
+		scene_graph.insertObjects(inserts);
+		for (size_t i = 0; i < inserts.size(); i++) {
+			if (scene_graph.contains(inserts[i])) {
+				m_grid.insert(inserts[i]);
+				queueMoved(inserts[i], false);
+			}
+		}
+	}
+}
+
+int df::WorldManager::applyObjectCommands(const std::vector<Command>& commands, size_t begin, size_t end, std::vector<df::Object*>* p_inserts) {
+	df::Object* p_o = commands[begin].p_object;
+	// Only the first old value of each kind matters: it is what the SceneGraph last saw.
+	bool insert = false;
+	bool seen[(int)Change::VISIBLE + 1] = {};
+	int old_value[(int)Change::VISIBLE + 1] = {};
+	for (size_t i = begin; i < end; i++) {
+		int kind = (int)commands[i].change;
+		if (commands[i].change == Change::INSERT) {
+			insert = true;
+		}
+		else if (!seen[kind]) {
+			seen[kind] = true;
+			old_value[kind] = commands[i].old_value;
+		}
+	}
+	int result = 0;
+	if (seen[(int)Change::TYPE] && scene_graph.updateType(p_o, old_value[(int)Change::TYPE])) {
+		result = -1;
+	}
+	if (!scene_graph.contains(p_o)) {
+		if (!insert) {
+			return result; // Not in world yet. Picked up on insert.
+		}
+		// Inserted with the Object's current state, so its other changes are already included.
+		if (p_inserts) {
+			p_inserts->push_back(p_o);
+			return result;
+		}
+		if (scene_graph.insertObject(p_o)) {
+			return -1;
+		}
+		m_grid.insert(p_o);
+		queueMoved(p_o, false);
+		return result;
+	}
+	if (seen[(int)Change::ALTITUDE] && scene_graph.updateAltitude(p_o, old_value[(int)Change::ALTITUDE])) {
+		result = -1;
+	}
+	if (seen[(int)Change::SOLIDNESS] && scene_graph.updateSolidness(p_o, old_value[(int)Change::SOLIDNESS] != 0)) {
+		result = -1;
+	}
+	if (seen[(int)Change::ACTIVE] && scene_graph.updateActive(p_o, old_value[(int)Change::ACTIVE] != 0)) {
+		result = -1;
+	}
+	if (seen[(int)Change::VISIBLE] && scene_graph.updateVisible(p_o, old_value[(int)Change::VISIBLE] != 0)) {
+		result = -1;
+	}
+	return result;
+}
+
+bool df::WorldManager::isInserted(const df::Object* p_o) const {
+	if (scene_graph.contains(p_o)) {
+		return true;
+	}
+	for (size_t i = 0; i < m_commands.size(); i++) {
+		if (m_commands[i].p_object == p_o && m_commands[i].change == Change::INSERT) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool df::QueryFilter::accepts(const df::Object* p_o) const {
+	return p_o != p_exclude && p_o->isActive() && (type == -1 || p_o->getTypeId() == type) && (!solid_only || p_o->isSolid());
+}
+
+void df::WorldManager::updateLocation(df::Object* p_o) {
+	m_grid.update(p_o);
+	queueMoved(p_o, false);
+}
+
+int df::WorldManager::queryRadius(df::Vector center, float radius, std::vector<df::Object*>* p_out, df::QueryFilter filter) const {
+	p_out->clear();
+	const float radius_sq = radius * radius;
+	df::Box area(center - df::Vector(radius, radius), radius * 2, radius * 2);
+	m_grid.forEachNear(area, [&](df::Object* p_o) {
+		df::Vector d = p_o->getPosition() - center;
+		if (d.getX() * d.getX() + d.getY() * d.getY() <= radius_sq && filter.accepts(p_o)) {
+			p_out->push_back(p_o);
+		}
+	});
+	return (int)p_out->size();
+}
+
+int df::WorldManager::queryBox(df::Box box, std::vector<df::Object*>* p_out, df::QueryFilter filter) const {
+	p_out->clear();
+	const df::Aabb query = df::toAabb(box);
+	m_grid.forEachNear(box, [&](df::Object* p_o) {
+		if (df::aabbIntersectsAabb(p_o->getWorldAabb(), query) && filter.accepts(p_o)) {
+			p_out->push_back(p_o);
+		}
+	});
+	return (int)p_out->size();
+}
+
+df::Object* df::WorldManager::nearest(df::Vector center, df::QueryFilter filter, float max_dist) const {
+	// Grow the search square until something is found inside its inscribed circle.
+	float reach = m_grid.getCellSize();
+	while (true) {
+		if (reach > max_dist) {
+			reach = max_dist;
+		}
+		df::Object* p_best = NULL;
+		float best_sq = reach * reach;
+		df::Box area(center - df::Vector(reach, reach), reach * 2, reach * 2);
+		m_grid.forEachNear(area, [&](df::Object* p_o) {
+			df::Vector d = p_o->getPosition() - center;
+			float dist_sq = d.getX() * d.getX() + d.getY() * d.getY();
+			if (dist_sq <= best_sq && filter.accepts(p_o)) {
+				best_sq = dist_sq;
+				p_best = p_o;
+			}
+		});
+		if (p_best || reach >= max_dist) {
+			return p_best;
+		}
+		reach *= 2;
+	}
+}
+
+int df::WorldManager::setSimulationTiers(float full_margin, float reduced_margin, int reduced_rate) {
+	if (full_margin < 0 || reduced_margin < 0 || reduced_rate < 1) {
+		writeLog("ERROR", "Invalid simulation tiers %f, %f, %d.", full_margin, reduced_margin, reduced_rate);
+		return -1;
+	}
+	m_full_tier_margin = full_margin;
+	m_reduced_tier_margin = reduced_margin;
+	m_reduced_tier_rate = reduced_rate;
+	m_transforms.setReducedRate(reduced_rate);
+	return 0;
+}
+
 void df::WorldManager::update(int step_count) {
+	m_step_count = step_count;
 	// Delete pending objects.
-	df::ObjectListIterator toDelete(&m_deletions);
-	toDelete.first();
-	while (!toDelete.isDone()) {
-		scene_graph.removeObject(toDelete.currentObject());
-		delete toDelete.currentObject();
-		toDelete.next();
+	deleteMarked();
+	// Structural changes made by handlers wait until the loop is done, so the live lists are iterated.
+	beginIteration();
+	assignTiers(step_count);
+	stepParallel(step_count);
+	// Integrate and move only Objects that are moving. Still ones cost nothing.
+	m_moving.clear();
+	for (size_t i = 0; i < m_ticking.size(); i++) {
+		if (m_components.has(m_ticking[i].p_o, df::Component::VELOCITY)) {
+			m_transforms.setSteps(m_ticking[i].p_o->getSlot(), m_ticking[i].steps);
+			m_moving.push_back(m_ticking[i]);
+		}
 	}
-	m_deletions.clear();
-	// Move and dispatch step event for all active objects.
-	df::ObjectList ol = scene_graph.activeObjects();
-	df::ObjectListIterator toUpdate(&ol);
-	toUpdate.first();
+	m_transforms.integrate(df::GRAVITY);
+	for (size_t i = 0; i < m_moving.size(); i++) {
+		df::Object* p_o = m_moving[i].p_o;
+		df::Vector new_pos = p_o->getPosition() + p_o->getVelocity() * (float)m_moving[i].steps;
+		if (new_pos != p_o->getPosition()) {
+			m_move_steps = m_moving[i].steps;
+			moveObject(p_o, new_pos);
+			m_move_steps = 1;
+		}
+		// At rest and nothing to get it moving again. setVelocity() adds it back.
+		if (p_o->getVelocity() == df::Vector() && !m_components.has(p_o, df::Component::GRAVITY)) {
+			m_components.remove(p_o, df::Component::VELOCITY);
+			m_transforms.setMoving(p_o->getSlot(), false);
+		}
+	}
+	endContacts(step_count);
+	processMoved();
+	// Dispatch step event to listeners.
 	df::EventStep e_step(step_count);
-	std::string x = "";
-	while (!toUpdate.isDone() && toUpdate.currentObject()) {
-		if (df::boxIntersectsBox(df::getWorldBox(toUpdate.currentObject()), df::Box(view.getCorner() - 20, view.getHorizontal() + 40, view.getVertical() + 40))) {
-			if (toUpdate.currentObject()->hasGravity()) {
-				df::Vector currentVelocity = toUpdate.currentObject()->getVelocity();
-				toUpdate.currentObject()->setVelocity(df::Vector(currentVelocity.getX(), currentVelocity.getY() + df::GRAVITY));
+	for (size_t i = 0; i < m_ticking.size(); i++) {
+		if (m_components.has(m_ticking[i].p_o, df::Component::STEP_LISTENER)) {
+			e_step.setStepDelta(m_ticking[i].steps);
+			m_ticking[i].p_o->eventHandler(&e_step);
+		}
+	}
+	endIteration();
+}
+
+void df::WorldManager::assignTiers(int step_count) {
+	m_ticking.clear();
+	const float full = m_full_tier_margin, outer = m_full_tier_margin + m_reduced_tier_margin;
+	const df::Aabb full_box = { view.getCorner().getX() - full, view.getCorner().getY() - full,
+		view.getCorner().getX() + view.getHorizontal() + full, view.getCorner().getY() + view.getVertical() + full };
+	const df::Aabb outer_box = { full_box.min_x - m_reduced_tier_margin, full_box.min_y - m_reduced_tier_margin,
+		full_box.max_x + m_reduced_tier_margin, full_box.max_y + m_reduced_tier_margin };
+	const int rate = m_reduced_tier_rate;
+	m_grid.forEachNearTiered(full_box, outer > full ? outer_box : full_box, [&](df::Object* p_o, bool in_full) {
+		if (!p_o->isActive() || p_o->isViewObject()) {
+			return;
+		}
+		if (in_full) {
+			Tick tick = { p_o, 1 };
+			m_ticking.push_back(tick);
+		}
+		else if ((step_count + p_o->getHandle().getIndex()) % rate == 0) {
+			Tick tick = { p_o, rate };
+			m_ticking.push_back(tick);
+		}
+	});
+	// View objects are drawn over the view wherever their position is, so they always update.
+	const std::vector<df::Object*>& listeners = m_components.members(df::Component::STEP_LISTENER);
+	for (size_t i = 0; i < listeners.size(); i++) {
+		if (listeners[i]->isViewObject() && listeners[i]->isActive() && scene_graph.contains(listeners[i])) {
+			Tick tick = { listeners[i], 1 };
+			m_ticking.push_back(tick);
+		}
+	}
+}
+
+void df::WorldManager::sendContact(df::Object* p_mover, df::Object* p_other, df::Vector position) {
+	df::CollisionPhase phase;
+	if (!m_contacts.touch(p_mover->getHandle(), p_other->getHandle(), position, m_step_count, m_move_steps, &phase)) {
+		return;
+	}
+	const df::EventCollision c(p_mover, p_other, position, phase);
+	if (p_mover->wantsCollisionPhase(phase)) {
+		p_mover->eventHandler(&c);
+	}
+	if (p_other->wantsCollisionPhase(phase)) {
+		p_other->eventHandler(&c);
+	}
+}
+
+void df::WorldManager::endContacts(int step_count) {
+	m_ended.clear();
+	m_contacts.expire(step_count, &m_ended);
+	for (size_t i = 0; i < m_ended.size(); i++) {
+		df::Object* p_mover = getObject(m_ended[i].mover);
+		df::Object* p_other = getObject(m_ended[i].other);
+		if (!p_mover || !p_other || p_mover->isMarkedForDelete() || p_other->isMarkedForDelete()) {
+			continue;
+		}
+		const df::EventCollision c(p_mover, p_other, m_ended[i].position, df::CollisionPhase::END);
+		if (p_mover->wantsCollisionPhase(df::CollisionPhase::END)) {
+			p_mover->eventHandler(&c);
+		}
+		if (p_other->wantsCollisionPhase(df::CollisionPhase::END)) {
+			p_other->eventHandler(&c);
+		}
+	}
+}
+
+void df::WorldManager::queueMoved(df::Object* p_o, bool by_move) {
+	Moved moved = { p_o->getHandle(), p_o->getWorldAabb(), by_move };
+	m_moved.push_back(moved);
+}
+
+void df::WorldManager::processMoved() {
+	// Occupancy lapses without events once either side is deleted.
+	m_occupants.erase(std::remove_if(m_occupants.begin(), m_occupants.end(), [this](const Occupant& occupant) {
+		return !getObject(occupant.trigger) || !getObject(occupant.object);
+	}), m_occupants.end());
+	if (m_moved.empty()) {
+		return;
+	}
+	// Handlers may move Objects again. Those wait for the next pass.
+	std::vector<Moved> moved;
+	moved.swap(m_moved);
+	// Group repeats of the same Object, keeping call order within each.
+	std::stable_sort(moved.begin(), moved.end(), [](const Moved& a, const Moved& b) {
+		if (a.handle.getIndex() != b.handle.getIndex()) {
+			return a.handle.getIndex() < b.handle.getIndex();
+		}
+		return a.handle.getGeneration() < b.handle.getGeneration();
+	});
+	const df::Aabb boundary_box = df::toAabb(boundary), view_box = df::toAabb(view);
+	size_t begin = 0;
+	while (begin < moved.size()) {
+		size_t end = begin + 1;
+		while (end < moved.size() && moved[end].handle == moved[begin].handle) {
+			end++;
+		}
+		// The first moveObject() of the pass has the box the Object started from.
+		const Moved* p_first_move = NULL;
+		for (size_t i = begin; i < end && !p_first_move; i++) {
+			if (moved[i].by_move) {
+				p_first_move = &moved[i];
 			}
-			df::Vector new_pos = toUpdate.currentObject()->predictPosition();
-			if (new_pos != toUpdate.currentObject()->getPosition()) {
-				moveObject(toUpdate.currentObject(), new_pos);
+		}
+		df::Object* p_o = getObject(moved[begin].handle);
+		begin = end;
+		if (!p_o || p_o->isMarkedForDelete()) {
+			continue;
+		}
+		if (p_first_move) {
+			const df::Aabb box0 = p_first_move->box0, box1 = p_o->getWorldAabb();
+			// Dispatch out event if object has moved off world or screen. Hard out event has priority as it implies a soft out event.
+			if (df::aabbIntersectsAabb(box0, boundary_box) && !df::aabbIntersectsAabb(box1, boundary_box)) {
+				const EventOut ov(true);
+				p_o->eventHandler(&ov);
+			}
+			else if (df::aabbIntersectsAabb(box0, view_box) && !df::aabbIntersectsAabb(box1, view_box)) {
+				const EventOut ov(false);
+				p_o->eventHandler(&ov);
 			}
-			toUpdate.currentObject()->eventHandler(&e_step);
 		}
-		toUpdate.next();
+		if (!p_o->isMarkedForDelete()) {
+			updateTriggers(p_o);
+		}
 	}
 }
 
-int df::WorldManager::markForDelete(Object* p_o) {
-	// Check object is not already marked for deletion.
-	df::ObjectListIterator li(&m_deletions);
-	li.first();
-	while (!li.isDone() && li.currentObject()) {
-		if (li.currentObject() == p_o) {
-			return 0;
+void df::WorldManager::updateTriggers(df::Object* p_o) {
+	const bool is_trigger = p_o->hasComponent(df::Component::TRIGGER);
+	const df::Handle handle = p_o->getHandle();
+	// What p_o overlaps now: Objects inside it if a trigger, else triggers it is inside.
+	m_overlapping.clear();
+	if (p_o->isActive() && m_grid.contains(p_o)) {
+		const df::Aabb box = p_o->getWorldAabb();
+		m_grid.forEachNear(box, [&](df::Object* p_near) {
+			if (p_near->isMarkedForDelete() || !df::aabbIntersectsAabb(p_near->getWorldAabb(), box)) {
+				return;
+			}
+			if (is_trigger) {
+				if (((df::Trigger*)p_o)->accepts(p_near)) {
+					m_overlapping.push_back(p_near);
+				}
+			}
+			else if (p_near->hasComponent(df::Component::TRIGGER) && ((df::Trigger*)p_near)->accepts(p_o)) {
+				m_overlapping.push_back(p_near);
+			}
+		});
+	}
+	// Leaves first, so an Object passing from one trigger into the next leaves before it enters.
+	for (size_t i = 0; i < m_occupants.size(); ) {
+		const Occupant occupant = m_occupants[i];
+		if ((is_trigger ? occupant.trigger : occupant.object) != handle) {
+			i++;
+			continue;
+		}
+		df::Object* p_other = getObject(is_trigger ? occupant.object : occupant.trigger);
+		if (std::find(m_overlapping.begin(), m_overlapping.end(), p_other) != m_overlapping.end()) {
+			i++;
+			continue;
+		}
+		m_occupants.erase(m_occupants.begin() + i);
+		const df::EventTrigger t(getObject(occupant.trigger), getObject(occupant.object), false);
+		t.getTrigger()->eventHandler(&t);
+		t.getObject()->eventHandler(&t);
+	}
+	for (size_t i = 0; i < m_overlapping.size(); i++) {
+		df::Object* p_trigger = is_trigger ? p_o : m_overlapping[i];
+		df::Object* p_object = is_trigger ? m_overlapping[i] : p_o;
+		bool inside = false;
+		for (size_t j = 0; j < m_occupants.size() && !inside; j++) {
+			inside = m_occupants[j].trigger == p_trigger->getHandle() && m_occupants[j].object == p_object->getHandle();
+		}
+		if (inside) {
+			continue;
+		}
+		Occupant occupant = { p_trigger->getHandle(), p_object->getHandle() };
+		m_occupants.push_back(occupant);
+		const df::EventTrigger t(p_trigger, p_object, true);
+		p_trigger->eventHandler(&t);
+		p_object->eventHandler(&t);
+	}
+}
+
+void df::WorldManager::stepParallel(int step_count) {
+	m_parallel.clear();
+	for (size_t i = 0; i < m_ticking.size(); i++) {
+		if (m_components.has(m_ticking[i].p_o, df::Component::AI)) {
+			m_parallel.push_back(m_ticking[i].p_o);
 		}
-		li.next();
 	}
-	m_deletions.insert(p_o);
+	if (m_parallel.empty()) {
+		return;
+	}
+	JM.parallelFor((int)m_parallel.size(), 16, [this, step_count](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			m_parallel[i]->stepParallel(step_count);
+		}
+	});
+	// Same order no matter which thread got to defer first.
+	std::stable_sort(m_deferred.begin(), m_deferred.end(), [](const Deferred& a, const Deferred& b) {
+		return a.id < b.id;
+	});
+	std::vector<Deferred> deferred;
+	deferred.swap(m_deferred);
+	for (size_t i = 0; i < deferred.size(); i++) {
+		deferred[i].action();
+	}
+}
+
+void df::WorldManager::defer(const df::Object* p_o, std::function<void()> action) {
+	Deferred deferred = { p_o->getId(), std::move(action) };
+	std::lock_guard<std::mutex> lock(m_deferred_mutex);
+	m_deferred.push_back(std::move(deferred));
+}
+
+int df::WorldManager::markForDelete(Object* p_o) {
+	if (!p_o) {
+		return -1;
+	}
+	if (p_o->m_marked_for_delete) {
+		return 0; // Already marked.
+	}
+	p_o->m_marked_for_delete = true;
+	m_deletions.push_back(p_o);
 	return 0;
 }
 
+void df::WorldManager::deleteMarked() {
+	if (m_deletions.empty()) {
+		return;
+	}
+	// Destructors may mark more Objects. Those wait for the next phase.
+	std::vector<df::Object*> doomed;
+	doomed.swap(m_deletions);
+	for (size_t i = 0; i < doomed.size(); i++) {
+		m_grid.remove(doomed[i]);
+	}
+	// The sweep ignores Object state, so changes still waiting for the sync point can just be dropped.
+	m_commands.erase(std::remove_if(m_commands.begin(), m_commands.end(), [](const Command& command) {
+		return command.p_object->isMarkedForDelete();
+	}), m_commands.end());
+	scene_graph.removeMarked();
+	m_components.removeMarked();
+	GM.removeMarked();
+	IM.removeMarked();
+	removeMarked();
+	// Indices are compacted, so destructors run against a consistent world.
+	for (size_t i = 0; i < doomed.size(); i++) {
+		delete doomed[i];
+	}
+}
+
 void df::WorldManager::draw() {
+	beginIteration();
+	// Cull against the view in one batch. View objects are always drawn, so they go in with the view as their box.
+	const df::Aabb view_box = df::toAabb(view);
+	m_drawn.clear();
+	m_draw_boxes.clear();
+	df::ObjectListIterator li(&scene_graph.activeObjects());
+	for (li.first(); !li.isDone() && li.currentObject(); li.next()) {
+		m_drawn.push_back(li.currentObject());
+		m_draw_boxes.add(li.currentObject()->isViewObject() ? view_box : li.currentObject()->getWorldAabb());
+	}
+	m_draw_boxes.intersect(view_box, &m_in_view);
 	// Draw objects in increasing altitude to keep z-index consistent.
 	for (int alt = 0; alt <= df::MAX_ALTITUDE; alt++) {
-		df::ObjectList ol = scene_graph.activeObjects();
-		df::ObjectListIterator li(&ol);
-		li.first();
-		while (!li.isDone() && li.currentObject()) {
-			// Only draw if on current layer and is (in bounds or a is view object)
-			if (li.currentObject()->getAltitude() == alt && (df::boxIntersectsBox(df::getWorldBox(li.currentObject()), view) || li.currentObject()->isViewObject())) {
-				li.currentObject()->draw();
+		for (size_t i = 0; i < m_in_view.size(); i++) {
+			df::Object* p_o = m_drawn[m_in_view[i]];
+			if (p_o->getAltitude() == alt) {
+				p_o->draw();
 			}
-			li.next();
 		}
 	}
+	// Advance animations of what was drawn. Draw handlers can't change the world, so members are iterated live.
+	const std::vector<df::Object*>& animated = m_components.members(df::Component::ANIMATED);
+	for (size_t i = 0; i < animated.size(); i++) {
+		df::Object* p_o = animated[i];
+		if (p_o->isActive() && p_o->isVisible() && (p_o->isViewObject() || df::aabbIntersectsAabb(p_o->getWorldAabb(), view_box)) && scene_graph.contains(p_o)) {
+			p_o->getAnimation()->step();
+		}
+	}
+	endIteration();
 }
 
 int df::WorldManager::moveObject(df::Object* p_o, Vector where) {
 	if (!p_o) { // Can't move what doesn't exist.
 		return -1;
 	}
-	df::Box box0 = df::getWorldBox(p_o);
+	// Collision handlers may change the world mid-move.
+	beginIteration();
+	queueMoved(p_o, true);
 	// Check for collision that will impede movement.
 	if (p_o->isSolid()) {
 
@@ -209,6 +772,10 @@ int df::WorldManager::moveObject(df::Object* p_o, Vector where) {
 		// once a collision on one axis happens, we don't need to check that axis anymore this tick
 		bool canMoveX = true;
 		bool canMoveY = true;
+
+		// sides blocked, and what blocked the move down, recorded on the object after it moves
+		int contacts = 0;
+		df::Object* p_ground = NULL;
 		for(int step = 0; step < nSteps; step++) {
 			if(!canMoveX && !canMoveY) break;
 
@@ -229,6 +796,7 @@ int df::WorldManager::moveObject(df::Object* p_o, Vector where) {
 						collided.insert(p_temp_o);
 						if((p_o->getSolidness() == df::Solidness::HARD && p_temp_o->getSolidness() == df::Solidness::HARD) || (p_o->getNoSoft() && p_temp_o->getSolidness() == df::Solidness::SOFT)) {
 							canMoveX = false; // Do not allow movement if both objects are HARD or the main object is impeded by SOFT and the other object is SOFT.
+							contacts |= dx < 0 ? df::CONTACT_WALL_LEFT : df::CONTACT_WALL_RIGHT;
 						}
 						li.next();
 					}
@@ -257,6 +825,12 @@ int df::WorldManager::moveObject(df::Object* p_o, Vector where) {
 						collided.insert(p_temp_o);
 						if((p_o->getSolidness() == df::Solidness::HARD && p_temp_o->getSolidness() == df::Solidness::HARD) || (p_o->getNoSoft() && p_temp_o->getSolidness() == df::Solidness::SOFT)) {
 							canMoveY = false; // Do not allow movement if both objects are HARD or the main object is impeded by SOFT and the other object is SOFT.
+							if(dy > 0) {
+								contacts |= df::CONTACT_GROUND;
+								if(!p_ground) p_ground = p_temp_o;
+							} else {
+								contacts |= df::CONTACT_CEILING;
+							}
 						}
 						li.next();
 					}
@@ -273,22 +847,21 @@ int df::WorldManager::moveObject(df::Object* p_o, Vector where) {
 
 		}
 
-		// send collision events
+		// send collision events, only where the contact is news
 		for(auto& obj : collided) {
-			df::EventCollision c(p_o, obj, endPos);
-			// Dispatch collision event to both objects.
-			p_o->eventHandler(&c);
-			obj->eventHandler(&c);
+			sendContact(p_o, obj, endPos);
 		}
 
 		// move to the final position
 		p_o->setPosition(endPos);
+		p_o->m_contact_flags = contacts;
+		p_o->m_ground = p_ground ? p_ground->getHandle() : df::Handle();
 	} else {
 		// non-solid
 		p_o->setPosition(where);
 	}
 
-	if (p_view_following == p_o) {
+	if (m_view_following == p_o->getHandle()) {
 		float view_center_x = view.getCorner().getX() + view.getHorizontal() / 2;
 		float view_center_y = view.getCorner().getY() + view.getVertical() / 2;
 
@@ -319,16 +892,7 @@ int df::WorldManager::moveObject(df::Object* p_o, Vector where) {
 		// Set new view position.
 		setViewPosition(Vector(view_center_x, view_center_y));
 	}
-	df::Box box1 = df::getWorldBox(p_o);
-	// Dispatch out event if object has moved off world or screen. Hard out event has priority as it implies a soft out event.
-	if (df::boxIntersectsBox(box0, boundary) && !df::boxIntersectsBox(box1, boundary)) {
-		const EventOut ov(true);
-		p_o->eventHandler(&ov);
-	}
-	else if (df::boxIntersectsBox(box0, view) && !df::boxIntersectsBox(box1, view)) {
-		const EventOut ov(false);
-		p_o->eventHandler(&ov);
-	}
+	endIteration();
 	return 0;
 }
 
@@ -344,32 +908,47 @@ df::ObjectList df::WorldManager::getCollisions(const df::Object* p_o, df::Vector
 	if (!p_o->isSolid()) {
 		return collList;
 	}
-	const df::ObjectList ol = scene_graph.activeObjects();
-	df::ObjectListIterator li(&ol);
-	li.first();
-	while (!li.isDone() && li.currentObject()) {
-		df::Object* p_temp = li.currentObject();
-		if (p_temp && p_o != p_temp && df::boxIntersectsBox(df::getWorldBox(p_o, where), df::getWorldBox(p_temp)) && p_temp->isSolid()) {
-			collList.insert(p_temp); // Add item to collision list if overlaps with p_o at where.
+	// Broad phase: solid Objects in grid cells near where. Narrow phase: one batch box test.
+	// Scratch space is per thread since this may be called from stepParallel().
+	static thread_local std::vector<df::Object*> candidates;
+	static thread_local df::BoxBatch boxes;
+	static thread_local std::vector<int> hits;
+	const df::Aabb query = df::toAabb(df::getWorldBox(p_o, where));
+	candidates.clear();
+	boxes.clear();
+	m_grid.forEachNear(query, [&](df::Object* p_temp) {
+		if (p_temp != p_o && p_temp->isActive() && p_temp->isSolid()) {
+			candidates.push_back(p_temp);
+			boxes.add(p_temp->getWorldAabb());
 		}
-		li.next();
+	});
+	boxes.intersect(query, &hits);
+	for (size_t i = 0; i < hits.size(); i++) {
+		collList.insert(candidates[hits[i]]); // Add item to collision list if overlaps with p_o at where.
 	}
 	return collList;
 }
 
-int df::WorldManager::onEvent(const Event* p_event) const {
+int df::WorldManager::onEvent(const Event* p_event) {
 	if (!p_event) {
 		return -1;
 	}
+	if (p_event->getType() == df::STEP_EVENT) {
+		return 0; // Delivered by update(), to the Objects ticking this step.
+	}
 	int count = 0;
-	df::ObjectList ol = getAllObjects();
-	df::ObjectListIterator li(&ol);
-	li.first();
-	while (!li.isDone() && li.currentObject()) {
-		li.currentObject()->eventHandler(p_event);
-		li.next();
-		count++;
+	beginIteration();
+	const df::ObjectList* lists[] = { &scene_graph.activeObjects(), &scene_graph.inactiveObjects() };
+	for (int i = 0; i < 2; i++) {
+		df::ObjectListIterator li(lists[i]);
+		li.first();
+		while (!li.isDone() && li.currentObject()) {
+			li.currentObject()->eventHandler(p_event);
+			li.next();
+			count++;
+		}
 	}
+	endIteration();
 	return count;
 }
 
@@ -409,26 +988,15 @@ void df::WorldManager::setViewPosition(df::Vector view_pos) {
 
 int df::WorldManager::setViewFollowing(df::Object* p_new_view_following) {
 	if (!p_new_view_following) {
-		p_view_following = NULL;
+		m_view_following = df::Handle();
 		return 0;
 	}
-	if (p_view_following == p_new_view_following) {
+	if (m_view_following == p_new_view_following->getHandle()) {
 		return 0;
 	}
-	df::ObjectList ol = getAllObjects();
-	df::ObjectListIterator li(&ol);
-	li.first();
-	bool found = false;
-	while (!li.isDone() && li.currentObject()) {
-		if (li.currentObject() == p_new_view_following) {
-			found = true;
-			break;
-		}
-		li.next();
-	}
-	if (found) {
-		p_view_following = p_new_view_following;
-		setViewPosition(p_view_following->getPosition());
+	if (isInserted(p_new_view_following)) {
+		m_view_following = p_new_view_following->getHandle();
+		setViewPosition(p_new_view_following->getPosition());
 		return 0;
 	}
 	return -1;
@@ -442,7 +1010,23 @@ df::Vector df::WorldManager::getViewSlack() const {
 	return view_slack;
 }
 
-df::SceneGraph df::WorldManager::getSceneGraph() const {
+df::TransformStore& df::WorldManager::getTransforms() {
+	return m_transforms;
+}
+
+df::HandleTable& df::WorldManager::getHandles() {
+	return m_handles;
+}
+
+df::ComponentRegistry& df::WorldManager::getComponents() {
+	return m_components;
+}
+
+df::Object* df::WorldManager::getObject(df::Handle handle) const {
+	return m_handles.resolve(handle);
+}
+
+const df::SceneGraph& df::WorldManager::getSceneGraph() const {
 	return scene_graph;
 }
 
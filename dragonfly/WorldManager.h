@@ -7,17 +7,47 @@
 #ifndef __WORLD_MANAGER_H__
 #define __WORLD_MANAGER_H__
 
+// System includes.
+#include <functional>
+#include <mutex>
+#include <vector>
+
 // Engine includes.
 #include "Manager.h"
 #include "ObjectList.h"
 #include "Vector.h"
+#include "BoxBatch.h"
+#include "ComponentRegistry.h"
+#include "ContactCache.h"
+#include "Handle.h"
 #include "SceneGraph.h"
+#include "SpatialGrid.h"
+#include "TransformStore.h"
 
 // Two-letter acronym for easier access to manager.
 #define WM df::WorldManager::getInstance()
 
 namespace df {
 	const float GRAVITY = 0.04; // Velocity in positive y (down) added every frame
+
+	// Default simulation tiers (see WorldManager::setSimulationTiers()).
+	const float FULL_TIER_MARGIN_DEFAULT = 20;    // Spaces around the view updated every step.
+	const float REDUCED_TIER_MARGIN_DEFAULT = 60; // Spaces beyond that updated at a reduced rate.
+	const int REDUCED_TIER_RATE_DEFAULT = 4;      // Reduced tier updates once every this many steps.
+
+	// Which Objects a spatial query reports. Inactive Objects are never reported.
+	struct QueryFilter {
+		StringId type = -1;           // Only Objects of this interned type (-1 for any).
+		bool solid_only = false;      // Only solid Objects.
+		const Object* p_exclude = NULL; // Never this Object (e.g., the one asking).
+
+		QueryFilter() {}
+		explicit QueryFilter(StringId only_type, const Object* p_excluded = NULL) : type(only_type), p_exclude(p_excluded) {}
+
+		// Return true if Object passes the filter.
+		bool accepts(const Object* p_o) const;
+	};
+
 	class WorldManager : public Manager {
 	private:
 		WorldManager();                 // Private since a singleton.
@@ -25,10 +55,123 @@ namespace df {
 		void operator=(WorldManager const&); // Don't allow assignment.
 		Box boundary; // World boundary.
 		Box view; // Player view of game world.
-		Object* p_view_following; // Object view is following.
+		Handle m_view_following; // Object view is following.
 		Vector view_slack;
-		ObjectList m_deletions; // Objects to delete.
+		std::vector<Object*> m_deletions; // Objects marked for delete.
 		SceneGraph scene_graph; // Storage for all Objects.
+		SpatialGrid m_grid; // Objects by location, for spatial queries.
+		TransformStore m_transforms; // Position, velocity and box of all Objects.
+		HandleTable m_handles; // Handles of all Objects.
+		ComponentRegistry m_components; // Which Objects each system visits.
+		ContactCache m_contacts;        // Pairs in contact, for collision phases.
+		std::vector<Contact> m_ended;   // Contacts ended this step.
+		int m_step_count;               // Step being updated (last one, between updates).
+		int m_move_steps;               // Steps the current moveObject() stands for.
+		// Object moved since the last moved pass.
+		struct Moved {
+			Handle handle;
+			Aabb box0;    // World box before the move (used if by_move).
+			bool by_move; // Moved by moveObject(), so checked for EventOut.
+		};
+		std::vector<Moved> m_moved;       // Objects moved since the last moved pass (repeats allowed).
+		// Object inside a trigger.
+		struct Occupant {
+			Handle trigger;
+			Handle object;
+		};
+		std::vector<Occupant> m_occupants;  // Objects inside each trigger.
+		std::vector<Object*> m_overlapping; // Scratch for updateTriggers().
+		// Object updated this step, with the number of steps the update stands for.
+		struct Tick {
+			Object* p_o;
+			int steps;
+		};
+		std::vector<Tick> m_ticking;   // Objects updated this step.
+		std::vector<Tick> m_moving;    // Objects in m_ticking with VELOCITY.
+		float m_full_tier_margin;      // Spaces around the view updated every step.
+		float m_reduced_tier_margin;   // Spaces beyond the full tier updated every m_reduced_tier_rate steps.
+		int m_reduced_tier_rate;       // Steps between updates in the reduced tier.
+		std::vector<Object*> m_drawn;    // Active Objects, in m_draw_boxes order.
+		BoxBatch m_draw_boxes;           // World boxes of m_drawn, culled against view.
+		std::vector<int> m_in_view;      // Indices into m_drawn of Objects in view.
+
+		// Action deferred from the parallel step phase, applied in Object id order.
+		struct Deferred {
+			int id;
+			std::function<void()> action;
+		};
+		std::mutex m_deferred_mutex;       // Guards m_deferred.
+		std::vector<Deferred> m_deferred;  // Deferred actions from this step.
+		std::vector<Object*> m_parallel;   // Objects in this step's parallel phase.
+
+		// Structural change to the SceneGraph.
+		enum class Change { INSERT, TYPE, ALTITUDE, SOLIDNESS, ACTIVE, VISIBLE };
+
+		// Change recorded while the world is being iterated, applied at the next sync point.
+		struct Command {
+			Object* p_object;
+			int id;        // Object id, for sorting.
+			Change change;
+			int old_value; // Type, altitude or flag before the change (unused for INSERT).
+		};
+		std::vector<Command> m_commands; // Changes waiting for the sync point, in call order.
+		int m_iterating;                 // Depth of nested iteration over the world.
+		int m_spawning;                  // Depth of nested spawn batches.
+		int m_spawned;                   // Objects constructed in the open spawn batch.
+
+		// Start iterating over the world. Structural changes are recorded until the matching endIteration().
+		void beginIteration();
+
+		// Stop iterating. Leaving the outermost iteration is the sync point that applies recorded changes.
+		void endIteration();
+
+		// Apply change now if not iterating, else record it.
+		// Return 0 if ok, else -1.
+		int record(Object* p_o, Change change, int old_value);
+
+		// Apply recorded changes in one pass, grouped by Object id, then call order.
+		void applyCommands();
+
+		// Apply all changes recorded for one Object. Changes are from commands[begin, end).
+		// If p_inserts is given, an Object to be inserted is added to it instead, for one bulk insert.
+		// Return 0 if ok, else -1.
+		int applyObjectCommands(const std::vector<Command>& commands, size_t begin, size_t end, std::vector<Object*>* p_inserts = NULL);
+
+		// Return true if Object is in the world or its insert is waiting for the sync point.
+		bool isInserted(const Object* p_o) const;
+
+		// Deletion phase. Sweep all Objects marked for delete out of the SceneGraph, spatial grid
+		// and interest lists in one pass each, then run their destructors.
+		void deleteMarked();
+
+		// Fill m_ticking with the active Objects to update this step, tiered through the spatial grid.
+		// View objects listening for steps are always in the full tier.
+		// Reduced tier Objects are spread over the steps by handle, so each step does a share of them.
+		void assignTiers(int step_count);
+
+		// Send collision event for contact between mover and other to both, if it is news.
+		// BEGIN always goes to both, STAY only to those wanting it (see Object::setCollisionPhases()).
+		void sendContact(Object* p_mover, Object* p_other, Vector position);
+
+		// End contacts not seen again in time, sending END to Objects wanting it.
+		// Contacts with a deleted Object end silently.
+		void endContacts(int step_count);
+
+		// Queue Object for the moved pass. by_move is for moveObject(), before it moves the Object.
+		// Also called on insert, so Objects placed inside a trigger enter it.
+		void queueMoved(Object* p_o, bool by_move);
+
+		// Moved pass, once per step. For each Object moved since the last pass, send EventOut if moveObject()
+		// took it off the world or screen, then send trigger events for triggers it entered or left.
+		void processMoved();
+
+		// Bring triggers Object is inside (or, for a trigger, Objects inside it) up to date.
+		// Send leave events, then enter events, to both the trigger and the Object.
+		void updateTriggers(Object* p_o);
+
+		// Run stepParallel() for AI Objects in m_ticking across all threads,
+		// then apply their deferred actions on the calling thread.
+		void stepParallel(int step_count);
 	public:
 		// Get the one and only instance of the WorldManager.
 		static WorldManager& getInstance();
@@ -41,38 +184,109 @@ namespace df {
 		void shutDown();
 
 		// Insert Object into world.
+		// While the world is being iterated, the insert happens at the next sync point.
 		// Return 0 if ok, else -1.
 		int insertObject(Object* p_o);
 
-		// Remove Object from world.
+		// Remove Object from world. Changes still waiting for the sync point are applied first.
+		// Called by the Object destructor. Use markForDelete() to delete while iterating.
 		// Return 0 if ok, else -1.
 		int removeObject(Object* p_o);
 
+		// Start spawning many Objects at once (e.g., building a level). expected pre-sizes storage.
+		// Until the matching endSpawnBatch(), new Objects skip per-Object logging,
+		// and their inserts wait so every index is filled in one pass.
+		void beginSpawnBatch(int expected = 0);
+
+		// Close spawn batch. Leaving the outermost batch inserts everything spawned in it
+		// (inserts wait for the sync point if the world is being iterated).
+		// Return number of Objects spawned.
+		int endSpawnBatch();
+
+		// Count newly constructed Object in the open spawn batch. Called by the Object constructor.
+		// Return true if added, false if no batch is open.
+		bool addToSpawnBatch(Object* p_o);
+
+		// Return true while a spawn batch is open.
+		bool isSpawning() const;
+
 		// Return list of all Objects in world.
 		ObjectList getAllObjects() const;
 
-		// Indicate Object is to be deleted at start of next game loop.
+		// Indicate Object is to be deleted at start of next game loop. O(1); marking twice is fine.
 		// Return 0 if ok, else -1.
 		int markForDelete(Object* p_o);
 
-		// Return all objects with the indicated type
+		// Return all active objects with the indicated type
 		ObjectList objectsOfType(std::string type) const;
 
-		// Update world.
+		// Return all objects (active or not) with the indicated interned type. O(1), no copy.
+		const std::vector<Object*>& objectsOfType(StringId type) const;
+
+		// Return first active object with the indicated interned type (e.g., the player), else NULL.
+		Object* firstOfType(StringId type) const;
+
+		// Object attribute changes that move it within the world. Called by the Object
+		// setters after the change, with the value before it.
+		// While the world is being iterated, they take effect at the next sync point.
+		// Return 0 if ok, else -1.
+		int updateType(Object* p_o, StringId old_type);
+		int updateAltitude(Object* p_o, int old_altitude);
+		int updateSolidness(Object* p_o, bool was_solid);
+		int updateActive(Object* p_o, bool was_active);
+		int updateVisible(Object* p_o, bool was_visible);
+
+		// Run action on the main thread after the parallel step phase.
+		// Safe to call from stepParallel(). Actions run in Object id order, then call order.
+		void defer(const Object* p_o, std::function<void()> action);
+
+		// Re-index Object in spatial grid after its position or box changed, and queue it for the moved pass.
+		// Called by Object::setPosition() and Object::setBox().
+		void updateLocation(Object* p_o);
+
+		// Fill p_out (cleared first) with Objects whose position is within radius of center.
+		// Return number found.
+		int queryRadius(Vector center, float radius, std::vector<Object*>* p_out, QueryFilter filter = QueryFilter()) const;
+
+		// Fill p_out (cleared first) with Objects whose world box intersects box.
+		// Return number found.
+		int queryBox(Box box, std::vector<Object*>* p_out, QueryFilter filter = QueryFilter()) const;
+
+		// Return Object whose position is nearest center and no further than max_dist, else NULL.
+		// Searches outward, so cost depends on what is nearby, not on the size of the world.
+		Object* nearest(Vector center, QueryFilter filter, float max_dist) const;
+
+		// Set simulation tiers around the view. Objects within full_margin of the view update every step.
+		// Objects within reduced_margin beyond that update every reduced_rate steps, each update standing for
+		// reduced_rate steps (scaled physics, EventStep::getStepDelta()). Objects further out are dormant.
+		// Tiers are to grid cell precision. A reduced_margin of 0 turns the reduced tier off.
+		// Return 0 if ok, else -1.
+		int setSimulationTiers(float full_margin, float reduced_margin, int reduced_rate);
+
+		// Update world. Each system only visits Objects being updated this step that have its component.
 		// Delete Objects marked for deletion.
-		// Update positions of Objects based on their velocities, generating collisions, as appropriate.
+		// Pick Objects to update from the simulation tiers.
+		// Run parallel step phase for AI Objects.
+		// Apply gravity and damping to VELOCITY Objects in one pass.
+		// Update their positions, generating collisions, as appropriate.
+		// End contacts no longer touching.
+		// Send out and trigger events for Objects that moved.
+		// Send step event to STEP_LISTENER Objects.
 		void update(int step_count);
 
 		// Draw all Objects in view.
 		// Draw bottom up, from 0 to MAX_ALTITUDE.
+		// Then step the animations of ANIMATED Objects in view.
 		void draw();
 
 		// Move Object. 
-		// If collision with solid, send collision events.
+		// If collision with solid, send collision events. A pair gets BEGIN the first step it touches and
+		// STAY each later step, at most once per step, until neither moves into the other (then END).
 		// If no collision with solid, move ok else don't move Object.
+		// Record sides blocked and what was stood on in the Object (see Object::getContacts()).
 		// If Object is Spectral, move ok.
 		// If move ok, adjust view if following this Object.
-		// If moved from inside world boundary to outside, generate EventOut.
+		// If moved from inside world boundary to outside, generate EventOut (in the moved pass, at the end of the step).
 		// Return 0 if move ok, else -1 if collision with solid.
 		int moveObject(Object* p_o, Vector where);
 
@@ -82,9 +296,10 @@ namespace df {
 		ObjectList getCollisions(const Object* p_o) const;
 		ObjectList getCollisions(const Object* p_o, Vector where) const;
 
-		// Dispatch event to all interested Objects.
+		// Dispatch event to all Objects. Step events are not dispatched here: update() sends them
+		// to the STEP_LISTENER Objects ticking that step, with their step delta.
 		// Return count of number of events sent.
-		int onEvent(const Event* p_event) const;
+		int onEvent(const Event* p_event);
 
 		// Set game world boundary.
 		void setBoundary(Box new_boundary);
@@ -111,8 +326,20 @@ namespace df {
 
 		Vector getViewSlack() const;
 
+		// Return store holding the position, velocity and box of all Objects.
+		TransformStore& getTransforms();
+
+		// Return table of Object handles.
+		HandleTable& getHandles();
+
+		// Return component membership of all Objects.
+		ComponentRegistry& getComponents();
+
+		// Return Object for handle, else NULL if it has been deleted. O(1).
+		Object* getObject(Handle handle) const;
+
 		// Return reference to the SceneGraph.
-		SceneGraph getSceneGraph() const;
+		const SceneGraph& getSceneGraph() const;
 
 		// Attempt to find a location to move the object so it won't have collisions.
 		// Returns the deltaPosition vector of a posible move location. Returns empty vector on failure to find a location.
@@ -25,15 +25,12 @@ bool df::positionsIntersect(df::Vector p1, df::Vector p2) {
 	return (abs(p1.getX() - p2.getX()) <= within && abs(p1.getY() - p2.getY()) <= within);
 }
 
-bool df::boxIntersectsBox(df::Box A, df::Box B) {
-	df::Vector aCorner = A.getCorner(), bCorner = B.getCorner();
-	// x1 true if bCorner is within A horizontally
-	// x2 true if aCorner is within B horizontally
-	// x3 true if bCorner is within A vertically
-	// x4 true if aCorner is within B vertically
-	bool x1 = bCorner.getX() <= aCorner.getX() && aCorner.getX() <= bCorner.getX() + B.getHorizontal(), x2 = aCorner.getX() <= bCorner.getX() && bCorner.getX() <= aCorner.getX() + A.getHorizontal(),
-		y1 = bCorner.getY() <= aCorner.getY() && aCorner.getY() <= bCorner.getY() + B.getVertical(), y2 = aCorner.getY() <= bCorner.getY() && bCorner.getY() <= aCorner.getY() + A.getVertical();
-	return (x1 || x2) && (y1 || y2);
+bool df::boxIntersectsBox(const df::Box& A, const df::Box& B) {
+	// Overlap (or touch) on both axes. Same test as BoxBatch::intersect().
+	const float a_x = A.getCorner().getX(), a_y = A.getCorner().getY();
+	const float b_x = B.getCorner().getX(), b_y = B.getCorner().getY();
+	return a_x <= b_x + B.getHorizontal() && b_x <= a_x + A.getHorizontal()
+		&& a_y <= b_y + B.getVertical() && b_y <= a_y + A.getVertical();
 }
 
 bool df::boxContainsPosition(df::Box box, df::Vector pos) {
@@ -116,6 +113,11 @@ int df::rand(unsigned long seed) {
 	return rand();
 }
 
+void df::setRandomSeed(unsigned long seed) {
+	g_next = seed;
+	srand(seed);
+}
+
 std::string df::getLine(std::ifstream* p_file) {
 	std::string line;
 	std::getline(*p_file, line);
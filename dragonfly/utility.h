@@ -24,7 +24,7 @@ namespace df {
 	bool valueInRange(float value, float min, float max);
 
 	// Return true if Boxes intersect.
-	bool boxIntersectsBox(Box box1, Box box2);
+	bool boxIntersectsBox(const Box& box1, const Box& box2);
 
 	// Return true if pos intersects box.
 	bool boxContainsPosition(Box box, Vector pos);
@@ -62,6 +62,9 @@ namespace df {
 	// Generate random integer with seed specified. Subsequent calls of rand() are based on this seed and it's generated numbers.
 	int rand(unsigned long seed);
 
+	// Seed both df::rand() and the C library rand().
+	void setRandomSeed(unsigned long seed);
+
 	// Get next line from file, with error checking ("" means error or empty line. Consider using a file ending line to distinguish EOF or error).
 	std::string getLine(std::ifstream* p_file);
 
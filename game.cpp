@@ -8,6 +8,7 @@
 #include "dragonfly/DisplayManager.h"
 #include "dragonfly/LogManager.h"
 #include "dragonfly/GameManager.h"
+#include "dragonfly/InputManager.h"
 #include "dragonfly/ResourceManager.h"
 #include "dragonfly/WorldManager.h"
 #include "dragonfly/utility.h"
@@ -16,6 +17,10 @@
 #include "Player.h"
 #include "EnemyBat.h"
 #include "EnemySlime.h"
+#include "FloorManager.h"
+
+// System includes.
+#include <cstring>
 
 // Function prototypes.
 void loadResources();
@@ -41,6 +46,19 @@ int main(int argc, char* argv[]) {
 	// Load game resources.
 	loadResources();
 
+	// "-record file" saves this session's input, "-replay file" plays a saved session back.
+	for (int i = 1; i + 1 < argc; i++) {
+		if (strcmp(argv[i], "-record") == 0) {
+			IM.startRecording(argv[i + 1], df::getTime());
+		}
+		else if (strcmp(argv[i], "-replay") == 0) {
+			IM.startReplay(argv[i + 1]);
+		}
+	}
+	if (IM.isRecording() || IM.isReplaying()) {
+		FM.setSeed(IM.getSeed());
+	}
+
 	// Run game.
 	GM.run();
 
@@ -49,28 +67,45 @@ int main(int argc, char* argv[]) {
 }
 
 void loadResources() {
+	// Everything below is looked up in the pack first (built with "dfasset pack assets.dfpak @tools/assets.txt").
+	// Without it the loose files are used.
+	RM.openPack("assets.dfpak");
+
+	// Needed for the first frame (start menu, player and the first floor's enemies).
 	RM.loadSprite("sprites/bat-spr.txt", "bat");
 	RM.loadSprite("sprites/slime-spr.txt", "slime");
-	RM.loadSprite("sprites/player-attack-spr-r.txt", "player-attack-r");
-	RM.loadSprite("sprites/player-attack-spr-l.txt", "player-attack-l");
 	RM.loadSprite("sprites/player-walk-spr.txt", "player-walk");
 	RM.loadSprite("sprites/player-idle-body-spr.txt", "player-idle-body");
-	RM.loadSprite("sprites/player-idle-feet-spr.txt", "player-idle-feet");
 	RM.loadSprite("sprites/player-bounds.txt", "player-bounds");
-	RM.loadSprite("sprites/gameover-spr.txt", "gameover");
 	RM.loadSprite("sprites/startmenu-spr.txt", "startmenu");
 
-	RM.loadSound("sounds/jump5.ogg", "jump");
-	RM.loadSound("sounds/hit2.ogg", "hit");
-	RM.loadSound("sounds/hurt3.ogg", "hurt");
-	RM.loadSound("sounds/error3.ogg", "bat_die");
-	RM.loadSound("sounds/fall5.ogg", "slime_die");
-	RM.loadSound("sounds/jump2.ogg", "slime_jump");
-	RM.loadSound("sounds/gameover4.ogg", "gameover");
+	// Attacks only exist once their sprite is set, so these can't wait for the background (hits and replays depend on them).
+	RM.loadSprite("sprites/player-attack-spr-r.txt", "player-attack-r");
+	RM.loadSprite("sprites/player-attack-spr-l.txt", "player-attack-l");
+
+	// Object archetypes (floor tiles, walls, enemies). Tunable without recompiling.
+	RM.loadPrefabs("prefabs/prefabs.txt");
 
-	RM.loadMusic("musics/Retro Mystic.ogg", "bgMusic");
+	// Everything else finishes in the background while the start menu is up.
+	std::vector<df::LoadRequest> requests;
+	requests.push_back(df::LoadRequest(df::ResourceType::SPRITE, "sprites/player-idle-feet-spr.txt", "player-idle-feet"));
+	requests.push_back(df::LoadRequest(df::ResourceType::SPRITE, "sprites/gameover-spr.txt", "gameover"));
 
-	df::Music* bgMusic = RM.getMusic("bgMusic");
-	bgMusic->getMusic()->setVolume(25);
-	bgMusic->play();
-}
\ No newline at end of file
+	requests.push_back(df::LoadRequest(df::ResourceType::SOUND, "sounds/jump5.ogg", "jump"));
+	requests.push_back(df::LoadRequest(df::ResourceType::SOUND, "sounds/hit2.ogg", "hit"));
+	requests.push_back(df::LoadRequest(df::ResourceType::SOUND, "sounds/hurt3.ogg", "hurt"));
+	requests.push_back(df::LoadRequest(df::ResourceType::SOUND, "sounds/error3.ogg", "bat_die"));
+	requests.push_back(df::LoadRequest(df::ResourceType::SOUND, "sounds/fall5.ogg", "slime_die"));
+	requests.push_back(df::LoadRequest(df::ResourceType::SOUND, "sounds/jump2.ogg", "slime_jump"));
+	requests.push_back(df::LoadRequest(df::ResourceType::SOUND, "sounds/gameover4.ogg", "gameover"));
+
+	requests.push_back(df::LoadRequest(df::ResourceType::MUSIC, "musics/Retro Mystic.ogg", "bgMusic", [](int result) {
+		if (result == 0) {
+			df::Music* bgMusic = RM.getMusic("bgMusic");
+			bgMusic->getMusic()->setVolume(25);
+			bgMusic->play();
+		}
+	}));
+
+	RM.loadBatch(requests);
+}
@@ -0,0 +1,159 @@
+/**
+	Offline asset compiler.
+	Usage:
+		dfasset sprite <in.txt> <out.dfs>      Compile a text sprite into the binary sprite format.
+		dfasset pack <out.dfpak> <file|@list>... Pack assets into one file. Text sprites are compiled on the way in.
+		                                        @list reads paths from a file, one per line.
+	@file dfasset.cpp
+	@author Dennis James Stelmach (dstelmach2@wpi.edu)
+*/
+
+// Engine includes.
+#include "../dragonfly/AssetPack.h"
+#include "../dragonfly/SpriteFile.h"
+
+// System includes.
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Read whole file into p_out.
+// Return 0 if ok, else -1.
+static int readFile(const std::string& filename, std::vector<char>* p_out) {
+	std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+	if (!file.good()) {
+		fprintf(stderr, "dfasset: cannot open '%s'.\n", filename.c_str());
+		return -1;
+	}
+	p_out->resize((size_t)file.tellg());
+	file.seekg(0);
+	if (!p_out->empty() && !file.read(p_out->data(), p_out->size())) {
+		fprintf(stderr, "dfasset: cannot read '%s'.\n", filename.c_str());
+		return -1;
+	}
+	return 0;
+}
+
+// Write p_data to file.
+// Return 0 if ok, else -1.
+static int writeFile(const std::string& filename, const std::vector<char>& data) {
+	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+	if (!file.good() || !file.write(data.data(), data.size())) {
+		fprintf(stderr, "dfasset: cannot write '%s'.\n", filename.c_str());
+		return -1;
+	}
+	return 0;
+}
+
+// Compile text sprite in_name to binary sprite out_name.
+// Return 0 if ok, else -1.
+static int compileSprite(const std::string& in_name, const std::string& out_name) {
+	std::vector<char> text;
+	if (readFile(in_name, &text) == -1) {
+		return -1;
+	}
+	df::SpriteData sprite;
+	std::string error;
+	if (df::parseSpriteText(text.data(), text.size(), &sprite, &error) == -1) {
+		fprintf(stderr, "dfasset: '%s': %s\n", in_name.c_str(), error.c_str());
+		return -1;
+	}
+	std::vector<char> binary;
+	df::writeSpriteBinary(sprite, &binary);
+	if (writeFile(out_name, binary) == -1) {
+		return -1;
+	}
+	printf("%s -> %s (%d frames, %dx%d, %d bytes)\n", in_name.c_str(), out_name.c_str(), sprite.frame_count, sprite.width, sprite.height, (int)binary.size());
+	return 0;
+}
+
+// Return true if file contents look like a text sprite.
+static bool isSpriteText(const std::vector<char>& data) {
+	const char* begin = "<" HEADER_TOKEN ">";
+	return data.size() >= strlen(begin) && memcmp(data.data(), begin, strlen(begin)) == 0;
+}
+
+// Add asset paths from arg to p_names, expanding @list files.
+// Return 0 if ok, else -1.
+static int addPackNames(const std::string& arg, std::vector<std::string>* p_names) {
+	if (arg.empty() || arg[0] != '@') {
+		p_names->push_back(arg);
+		return 0;
+	}
+	std::ifstream list(arg.substr(1).c_str());
+	if (!list.good()) {
+		fprintf(stderr, "dfasset: cannot open list '%s'.\n", arg.substr(1).c_str());
+		return -1;
+	}
+	std::string line;
+	while (std::getline(list, line)) {
+		if (!line.empty() && line[line.size() - 1] == '\r') {
+			line.erase(line.size() - 1);
+		}
+		if (!line.empty() && line[0] != '#') {
+			p_names->push_back(line);
+		}
+	}
+	return 0;
+}
+
+// Pack assets in names into out_name.
+// Return 0 if ok, else -1.
+static int buildPack(const std::string& out_name, const std::vector<std::string>& names) {
+	std::vector<df::PackSource> sources(names.size());
+	for (size_t i = 0; i < names.size(); i++) {
+		sources[i].name = names[i];
+		if (readFile(names[i], &sources[i].data) == -1) {
+			return -1;
+		}
+		if (isSpriteText(sources[i].data)) {
+			// Stored under its original name so loadSprite() finds it with or without the pack.
+			df::SpriteData sprite;
+			std::string error;
+			if (df::parseSpriteText(sources[i].data.data(), sources[i].data.size(), &sprite, &error) == -1) {
+				fprintf(stderr, "dfasset: '%s': %s\n", names[i].c_str(), error.c_str());
+				return -1;
+			}
+			df::writeSpriteBinary(sprite, &sources[i].data);
+		}
+	}
+	std::vector<char> pack;
+	std::string error;
+	if (df::AssetPack::write(&sources, &pack, &error) == -1) {
+		fprintf(stderr, "dfasset: %s\n", error.c_str());
+		return -1;
+	}
+	if (writeFile(out_name, pack) == -1) {
+		return -1;
+	}
+	printf("%s: %d assets, %d bytes\n", out_name.c_str(), (int)sources.size(), (int)pack.size());
+	return 0;
+}
+
+static void usage() {
+	fprintf(stderr, "usage: dfasset sprite <in.txt> <out.dfs>\n");
+	fprintf(stderr, "       dfasset pack <out.dfpak> <file|@list>...\n");
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		usage();
+		return 1;
+	}
+	if (strcmp(argv[1], "sprite") == 0 && argc == 4) {
+		return compileSprite(argv[2], argv[3]) == 0 ? 0 : 1;
+	}
+	if (strcmp(argv[1], "pack") == 0 && argc >= 3) {
+		std::vector<std::string> names;
+		for (int i = 3; i < argc; i++) {
+			if (addPackNames(argv[i], &names) == -1) {
+				return 1;
+			}
+		}
+		return buildPack(argv[2], names) == 0 ? 0 : 1;
+	}
+	usage();
+	return 1;
+}